@@ -1,64 +1,187 @@
 #pragma once
+#include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Владеет сырой, выровненной под Type, но не инициализированной памятью,
+// полученной от аллокатора Alloc, или чужой памятью с собственной функцией освобождения.
+// Чужая память - редкий случай, поэтому её функция и размер хранятся в отдельной записи,
+// а на её наличие указывает старший бит поля размера: обычный ArrayPtr не платит за неё памятью
+// ArrayPtr не создаёт и не разрушает элементы: это делает владелец,
+// который знает, какая часть буфера занята живыми объектами
+// Хранит аллокатор ArrayPtr. Пустой аллокатор становится базовым классом
+// и не занимает места, поэтому ArrayPtr с std::allocator - это два слова
+template <typename Alloc, bool = std::is_empty_v<Alloc> && !std::is_final_v<Alloc>>
+class ArrayPtrAllocHolder {
+protected:
+    ArrayPtrAllocHolder() = default;
+
+    explicit ArrayPtrAllocHolder(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    explicit ArrayPtrAllocHolder(Alloc&& alloc) noexcept
+        : alloc_(std::move(alloc)) {
+    }
+
+    Alloc& Allocator() noexcept {
+        return alloc_;
+    }
+
+    const Alloc& Allocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    Alloc alloc_;
+};
+
+template <typename Alloc>
+class ArrayPtrAllocHolder<Alloc, true> : private Alloc {
+protected:
+    ArrayPtrAllocHolder() = default;
+
+    explicit ArrayPtrAllocHolder(const Alloc& alloc) noexcept
+        : Alloc(alloc) {
+    }
+
+    explicit ArrayPtrAllocHolder(Alloc&& alloc) noexcept
+        : Alloc(std::move(alloc)) {
+    }
+
+    Alloc& Allocator() noexcept {
+        return *this;
+    }
+
+    const Alloc& Allocator() const noexcept {
+        return *this;
+    }
+};
+
+template <typename Type, typename Alloc = std::allocator<Type>>
+class ArrayPtr : private ArrayPtrAllocHolder<Alloc> {
+    using AllocHolder = ArrayPtrAllocHolder<Alloc>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocHolder::Allocator;
 
-template <typename Type>
-class ArrayPtr {
 public:
+    using allocator_type = Alloc;
+    // Освобождает чужую память: deleter(context, raw_ptr, size)
+    using Deleter = void (*)(void* context, Type* raw_ptr, size_t size);
+
     // Инициализирует ArrayPtr нулевым указателем
     ArrayPtr() = default;
 
-    // Создаёт в куче массив из size элементов типа Type.
+    explicit ArrayPtr(const Alloc& alloc) noexcept
+        : AllocHolder(alloc) {
+    }
+
+    // Выделяет неинициализированную память под size элементов типа Type.
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
-    explicit ArrayPtr(const size_t& size) {
-            if (size == 0) {raw_ptr_ = nullptr;}
-            else
-            {
-                raw_ptr_ = new Type[size];
-                
-                for (size_t i = 0; i<size; i++){
-                    raw_ptr_[i] = Type();
-                }
-            }
-        }
+    explicit ArrayPtr(const size_t& size, const Alloc& alloc = Alloc())
+        : AllocHolder(alloc)
+        , raw_ptr_(size == 0 ? nullptr : AllocTraits::allocate(Allocator(), size))
+        , size_(raw_ptr_ ? size : 0) {
+    }
 
-    explicit ArrayPtr(Type&& raw_ptr) noexcept   {
-        if (raw_ptr == nullptr){return;}
-            raw_ptr_= move(raw_ptr);
+    // Конструктор из сырого указателя на память под size элементов,
+    // выделенную аллокатором, равным alloc, либо nullptr
+    ArrayPtr(Type* raw_ptr, size_t size, const Alloc& alloc = Alloc()) noexcept
+        : AllocHolder(alloc)
+        , raw_ptr_(raw_ptr)
+        , size_(raw_ptr ? size : 0) {
     }
 
-    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-    explicit ArrayPtr(Type* raw_ptr) noexcept   {
-        if (raw_ptr == nullptr){return;}
-        raw_ptr_=raw_ptr;
+    // Конструктор из чужой памяти, которую освободит deleter(context, raw_ptr, size), а не аллокатор.
+    // Пустой deleter означает память аллокатора. Если конструктор выбросил исключение,
+    // память остаётся у вызывающего
+    ArrayPtr(Type* raw_ptr, size_t size, Deleter deleter, void* context, const Alloc& alloc = Alloc())
+        : AllocHolder(alloc)
+        , raw_ptr_(raw_ptr)
+        , size_(raw_ptr ? size : 0) {
+        if (raw_ptr != nullptr && deleter != nullptr) {
+            size_ = EncodeAdopted(new Adopted{size, deleter, context});
+        }
     }
 
     // Запрещаем копирование
     ArrayPtr(const ArrayPtr&) = delete;
+    ArrayPtr& operator=(const ArrayPtr&) = delete;
 
-    ~ArrayPtr() {
-   if(raw_ptr_ != nullptr){
-        delete[] raw_ptr_;
+    ArrayPtr(ArrayPtr&& other) noexcept
+        : AllocHolder(std::move(other.Allocator()))
+        , raw_ptr_(std::exchange(other.raw_ptr_, nullptr))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Аллокатор перенимается, только если это разрешает
+    // propagate_on_container_move_assignment, иначе аллокаторы обязаны быть равны
+    ArrayPtr& operator=(ArrayPtr&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                Allocator() = std::move(other.Allocator());
+            } else {
+                assert(Allocator() == other.Allocator());
+            }
+            raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+            size_ = std::exchange(other.size_, 0);
         }
-   }
+        return *this;
+    }
 
-    ArrayPtr& operator=(const ArrayPtr&) = delete;
-    ArrayPtr& operator=(ArrayPtr&& Ar){
-        swap(Ar);
-        return raw_ptr_;
+    // Освобождает память, не вызывая деструкторы элементов
+    ~ArrayPtr() {
+        Reset();
+    }
+
+    // Возвращает память аллокатору или чужой функции освобождения.
+    // Элементы к этому моменту должны быть разрушены
+    void Reset() noexcept {
+        if (raw_ptr_ != nullptr) {
+            if (IsAdopted()) {
+                const Adopted adopted = *GetAdopted();
+                delete GetAdopted();
+                adopted.deleter(adopted.context, raw_ptr_, adopted.size);
+            } else {
+                AllocTraits::deallocate(Allocator(), raw_ptr_, size_);
+            }
+            raw_ptr_ = nullptr;
+            size_ = 0;
+        }
     }
 
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
-    // После вызова метода указатель на массив должен обнулиться
+    // После вызова метода указатель на массив должен обнулиться.
+    // Функцию освобождения чужой памяти нужно забрать до этого через GetDeleter
     [[nodiscard]] Type* Release() noexcept {
-         Type* a = raw_ptr_;
-         raw_ptr_ = nullptr;
-        return a;
+        if (IsAdopted()) {
+            delete GetAdopted();
+        }
+        size_ = 0;
+        return std::exchange(raw_ptr_, nullptr);
+    }
+
+    // Функция освобождения чужой памяти и её контекст; nullptr для памяти аллокатора
+    Deleter GetDeleter() const noexcept {
+        return IsAdopted() ? GetAdopted()->deleter : nullptr;
+    }
+
+    void* GetDeleterContext() const noexcept {
+        return IsAdopted() ? GetAdopted()->context : nullptr;
+    }
+
+    // Память освободит не аллокатор, а чужая функция
+    bool HasDeleter() const noexcept {
+        return IsAdopted();
     }
 
     // Возвращает ссылку на элемент массива с индексом index
     Type& operator[](size_t index) noexcept {
-
         return raw_ptr_[index];
     }
 
@@ -69,8 +192,7 @@ public:
 
     // Возвращает true, если указатель ненулевой, и false в противном случае
     explicit operator bool() const {
-        if (raw_ptr_ == nullptr){return false;}
-        return true;
+        return raw_ptr_ != nullptr;
     }
 
     // Возвращает значение сырого указателя, хранящего адрес начала массива
@@ -78,11 +200,63 @@ public:
         return raw_ptr_;
     }
 
-    // Обменивается значениям указателя на массив с объектом other
+    // Возвращает количество элементов, под которое выделена память
+    size_t GetSize() const noexcept {
+        return IsAdopted() ? GetAdopted()->size : size_;
+    }
+
+    Alloc& GetAllocator() noexcept {
+        return Allocator();
+    }
+
+    const Alloc& GetAllocator() const noexcept {
+        return Allocator();
+    }
+
+    // Обменивается значениям указателя на массив с объектом other.
+    // Аллокаторы остаются на месте, поэтому они должны быть равны
     void swap(ArrayPtr& other) noexcept {
+        assert(Allocator() == other.Allocator());
         std::swap(raw_ptr_, other.raw_ptr_);
+        std::swap(size_, other.size_);
+    }
+
+    // Обменивается массивом вместе с аллокатором
+    void SwapWithAllocator(ArrayPtr& other) noexcept {
+        using std::swap;
+        swap(Allocator(), other.Allocator());
+        swap(raw_ptr_, other.raw_ptr_);
+        swap(size_, other.size_);
     }
 
 private:
+    // Запись о чужой памяти
+    struct Adopted {
+        size_t size;
+        Deleter deleter;
+        void* context;
+    };
+
+    // Старший бит size_ отмечает чужую память; остальные биты хранят адрес записи,
+    // сдвинутый на бит вправо (запись выровнена, младший бит адреса всегда 0)
+    static constexpr size_t kAdoptedBit = ~(~size_t(0) >> 1);
+    static_assert(sizeof(std::uintptr_t) <= sizeof(size_t) && alignof(Adopted) > 1);
+
+    static size_t EncodeAdopted(Adopted* adopted) noexcept {
+        return kAdoptedBit | static_cast<size_t>(reinterpret_cast<std::uintptr_t>(adopted) >> 1);
+    }
+
+    bool IsAdopted() const noexcept {
+        return (size_ & kAdoptedBit) != 0;
+    }
+
+    Adopted* GetAdopted() const noexcept {
+        return reinterpret_cast<Adopted*>(static_cast<std::uintptr_t>(size_ << 1));
+    }
+
     Type* raw_ptr_ = nullptr;
+    // Вместимость или, для чужой памяти, закодированный адрес записи Adopted
+    size_t size_ = 0;
 };
+
+static_assert(sizeof(ArrayPtr<int>) == 2 * sizeof(void*), "std::allocator must not take space in ArrayPtr");
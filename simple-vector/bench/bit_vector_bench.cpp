@@ -0,0 +1,128 @@
+#include "../bit_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+// Каждый восьмой флаг установлен
+SimpleVector<bool> MakeFlags(size_t size, unsigned seed) {
+    std::mt19937 gen(seed);
+    SimpleVector<bool> flags(size);
+    for (size_t i = 0; i < size; ++i) {
+        flags[i] = gen() % 8 == 0;
+    }
+    return flags;
+}
+
+BitVector MakeBits(size_t size, unsigned seed) {
+    const auto flags = MakeFlags(size, seed);
+    BitVector bits(Reserve(size));
+    for (bool flag : flags) {
+        bits.PushBack(flag);
+    }
+    return bits;
+}
+
+void BM_AndSimpleVectorBool(benchmark::State& state) {
+    auto a = MakeFlags(state.range(0), 1);
+    const auto b = MakeFlags(state.range(0), 2);
+    for (auto _ : state) {
+        for (size_t i = 0; i < a.GetSize(); ++i) {
+            a[i] = a[i] && b[i];
+        }
+        benchmark::DoNotOptimize(a.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+    state.counters["bytes_per_flag"] = static_cast<double>(a.GetCapacity() * sizeof(bool)) / a.GetSize();
+}
+
+void BM_AndBitVector(benchmark::State& state) {
+    auto a = MakeBits(state.range(0), 1);
+    const auto b = MakeBits(state.range(0), 2);
+    for (auto _ : state) {
+        a.And(b);
+        benchmark::DoNotOptimize(a.Words());
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+    state.counters["bytes_per_flag"] = static_cast<double>(a.GetCapacity() / 8) / a.GetSize();
+}
+
+void BM_CountSimpleVectorBool(benchmark::State& state) {
+    const auto a = MakeFlags(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::count(a.begin(), a.end(), true));
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+void BM_CountBitVector(benchmark::State& state) {
+    const auto a = MakeBits(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+// Перебор установленных флагов
+void BM_ScanSimpleVectorBool(benchmark::State& state) {
+    const auto a = MakeFlags(state.range(0), 1);
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (size_t i = 0; i < a.GetSize(); ++i) {
+            if (a[i]) {
+                sum += i;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+void BM_ScanBitVector(benchmark::State& state) {
+    const auto a = MakeBits(state.range(0), 1);
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (size_t i = a.FindFirst(); i < a.GetSize(); i = a.FindNext(i)) {
+            sum += i;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+void BM_Rank(benchmark::State& state) {
+    const auto a = MakeBits(state.range(0), 1);
+    const RankSelect index(a);
+    std::mt19937_64 gen(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.Rank(gen() % a.GetSize()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Select(benchmark::State& state) {
+    const auto a = MakeBits(state.range(0), 1);
+    const RankSelect index(a);
+    std::mt19937_64 gen(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.Select(gen() % index.GetOnes()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_AndSimpleVectorBool)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_AndBitVector)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_CountSimpleVectorBool)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_CountBitVector)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_ScanSimpleVectorBool)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_ScanBitVector)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_Rank)->Range(1 << 12, 1 << 28);
+BENCHMARK(BM_Select)->Range(1 << 12, 1 << 28);
+
+}  // namespace
+
+BENCHMARK_MAIN();
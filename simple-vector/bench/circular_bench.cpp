@@ -0,0 +1,111 @@
+#include "../circular_simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <deque>
+
+namespace {
+
+// Очередь длиной state.range(0): на каждом шаге один элемент добавляется в конец
+// и один забирается из начала
+void BM_QueueSimpleVector(benchmark::State& state) {
+    const size_t length = state.range(0);
+    SimpleVector<std::int64_t> queue(length);
+    std::int64_t next = 0;
+    for (auto _ : state) {
+        queue.PushBack(next++);
+        benchmark::DoNotOptimize(queue[0]);
+        queue.Erase(queue.begin());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_QueueStdDeque(benchmark::State& state) {
+    std::deque<std::int64_t> queue(state.range(0));
+    std::int64_t next = 0;
+    for (auto _ : state) {
+        queue.push_back(next++);
+        benchmark::DoNotOptimize(queue.front());
+        queue.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_QueueCircular(benchmark::State& state) {
+    CircularSimpleVector<std::int64_t> queue(state.range(0));
+    std::int64_t next = 0;
+    for (auto _ : state) {
+        queue.PushBack(next++);
+        benchmark::DoNotOptimize(queue.Front());
+        queue.PopFront();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Вставка и удаление у начала: SimpleVector сдвигает весь буфер, кольцо - только меньшую часть
+void BM_InsertNearFrontSimpleVector(benchmark::State& state) {
+    SimpleVector<std::int64_t> v(state.range(0));
+    for (auto _ : state) {
+        v.Insert(v.begin() + 3, 1);
+        v.Erase(v.begin() + 5);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_InsertNearFrontCircular(benchmark::State& state) {
+    CircularSimpleVector<std::int64_t> v(state.range(0));
+    for (auto _ : state) {
+        v.Insert(v.begin() + 3, 1);
+        v.Erase(v.begin() + 5);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_IterateSimpleVector(benchmark::State& state) {
+    const SimpleVector<std::int64_t> v(state.range(0), 1);
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (std::int64_t x : v) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_IterateCircular(benchmark::State& state) {
+    const CircularSimpleVector<std::int64_t> v(state.range(0), 1);
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (std::int64_t x : v) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+// Окно последних значений телеметрии
+void BM_RingWindowPush(benchmark::State& state) {
+    RingWindow<std::int64_t> window(Reserve(state.range(0)));
+    std::int64_t next = 0;
+    for (auto _ : state) {
+        window.PushBack(next++);
+    }
+    benchmark::DoNotOptimize(window.Back());
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_QueueSimpleVector)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_QueueStdDeque)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_QueueCircular)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_InsertNearFrontSimpleVector)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_InsertNearFrontCircular)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_IterateSimpleVector)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IterateCircular)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_RingWindowPush)->Arg(1 << 10);
+
+}  // namespace
+
+BENCHMARK_MAIN();
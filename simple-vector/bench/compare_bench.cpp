@@ -0,0 +1,135 @@
+#include "../simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// Два равных вектора, отличающихся только последним элементом: худший случай для сравнения
+template <typename Type>
+std::pair<SimpleVector<Type>, SimpleVector<Type>> MakePair(size_t size) {
+    SimpleVector<Type> lhs(size);
+    for (size_t i = 0; i < size; ++i) {
+        lhs[i] = static_cast<Type>(i % 100);
+    }
+    SimpleVector<Type> rhs(lhs);
+    rhs[size - 1] = static_cast<Type>(rhs[size - 1] + 1);
+    return {std::move(lhs), std::move(rhs)};
+}
+
+template <typename Type>
+void BM_Equal(benchmark::State& state) {
+    const auto [lhs, rhs] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetBytesProcessed(state.iterations() * lhs.GetSize() * sizeof(Type) * 2);
+}
+
+template <typename Type>
+void BM_EqualStd(benchmark::State& state) {
+    const auto [lhs, rhs] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * lhs.GetSize() * sizeof(Type) * 2);
+}
+
+template <typename Type>
+void BM_LessEqual(benchmark::State& state) {
+    const auto [lhs, rhs] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs <= rhs);
+    }
+    state.SetBytesProcessed(state.iterations() * lhs.GetSize() * sizeof(Type) * 2);
+}
+
+// Прежняя реализация operator<=: проход на равенство и лексикографический проход
+template <typename Type>
+void BM_LessEqualStd(benchmark::State& state) {
+    const auto [lhs, rhs] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end())
+                                 || std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * lhs.GetSize() * sizeof(Type) * 2);
+}
+
+template <typename Type>
+void BM_Find(benchmark::State& state) {
+    const auto [v, unused] = MakePair<Type>(state.range(0));
+    const Type missing = static_cast<Type>(101);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Find(v, missing));
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(Type));
+}
+
+template <typename Type>
+void BM_FindStd(benchmark::State& state) {
+    const auto [v, unused] = MakePair<Type>(state.range(0));
+    const Type missing = static_cast<Type>(101);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(v.begin(), v.end(), missing));
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(Type));
+}
+
+template <typename Type>
+void BM_Count(benchmark::State& state) {
+    const auto [v, unused] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Count(v, Type{7}));
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(Type));
+}
+
+template <typename Type>
+void BM_CountStd(benchmark::State& state) {
+    const auto [v, unused] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::count(v.begin(), v.end(), Type{7}));
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(Type));
+}
+
+template <typename Type>
+void BM_MinElement(benchmark::State& state) {
+    const auto [v, unused] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MinElement(v));
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(Type));
+}
+
+template <typename Type>
+void BM_MinElementStd(benchmark::State& state) {
+    const auto [v, unused] = MakePair<Type>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::min_element(v.begin(), v.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(Type));
+}
+
+#define COMPARE_BENCHMARKS(Type)                                              \
+    BENCHMARK_TEMPLATE(BM_Equal, Type)->Range(1 << 8, 1 << 22);               \
+    BENCHMARK_TEMPLATE(BM_EqualStd, Type)->Range(1 << 8, 1 << 22);            \
+    BENCHMARK_TEMPLATE(BM_LessEqual, Type)->Range(1 << 8, 1 << 22);           \
+    BENCHMARK_TEMPLATE(BM_LessEqualStd, Type)->Range(1 << 8, 1 << 22);        \
+    BENCHMARK_TEMPLATE(BM_Find, Type)->Range(1 << 8, 1 << 22);                \
+    BENCHMARK_TEMPLATE(BM_FindStd, Type)->Range(1 << 8, 1 << 22);             \
+    BENCHMARK_TEMPLATE(BM_Count, Type)->Range(1 << 8, 1 << 22);               \
+    BENCHMARK_TEMPLATE(BM_CountStd, Type)->Range(1 << 8, 1 << 22);            \
+    BENCHMARK_TEMPLATE(BM_MinElement, Type)->Range(1 << 8, 1 << 22);          \
+    BENCHMARK_TEMPLATE(BM_MinElementStd, Type)->Range(1 << 8, 1 << 22)
+
+COMPARE_BENCHMARKS(std::uint8_t);
+COMPARE_BENCHMARKS(std::int32_t);
+COMPARE_BENCHMARKS(float);
+COMPARE_BENCHMARKS(double);
+
+}  // namespace
+
+BENCHMARK_MAIN();
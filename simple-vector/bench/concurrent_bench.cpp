@@ -0,0 +1,86 @@
+#include "../concurrent_simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace {
+
+// Общий вектор всех потоков замера; создаётся и разрушается потоком 0
+template <typename Vector>
+std::unique_ptr<Vector> shared_vector;
+
+std::mutex shared_mutex;
+
+template <typename Type>
+Type MakeItem(std::int64_t i) {
+    if constexpr (std::is_same_v<Type, std::string>) {
+        return std::to_string(i);
+    } else {
+        return static_cast<Type>(i);
+    }
+}
+
+template <typename Type>
+void BM_ConcurrentPushBack(benchmark::State& state) {
+    using Vector = ConcurrentSimpleVector<Type>;
+    if (state.thread_index() == 0) {
+        shared_vector<Vector> = std::make_unique<Vector>();
+    }
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shared_vector<Vector>->PushBack(MakeItem<Type>(i++)));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        shared_vector<Vector>.reset();
+    }
+}
+
+// Базовая линия: SimpleVector под общим мьютексом
+template <typename Type>
+void BM_MutexPushBack(benchmark::State& state) {
+    using Vector = SimpleVector<Type>;
+    if (state.thread_index() == 0) {
+        shared_vector<Vector> = std::make_unique<Vector>();
+    }
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        Type item = MakeItem<Type>(i++);
+        std::lock_guard guard(shared_mutex);
+        shared_vector<Vector>->PushBack(std::move(item));
+        benchmark::DoNotOptimize(shared_vector<Vector>->GetSize());
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        shared_vector<Vector>.reset();
+    }
+}
+
+// Сбор элементов из всех потоков в один непрерывный вектор
+void BM_ConcurrentFreeze(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        ConcurrentSimpleVector<std::int64_t> v;
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(i);
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(v.Freeze().begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentPushBack, std::int64_t)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexPushBack, std::int64_t)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentPushBack, std::string)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexPushBack, std::string)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentFreeze)->Range(1 << 10, 1 << 22);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+#include "../large_page_allocator.h"
+#include "../parallel.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+constexpr size_t kAccessesPerIteration = size_t(1) << 20;
+
+template <typename Alloc>
+SimpleVector<std::int64_t, Alloc> MakeVector(size_t size, const Alloc& alloc) {
+    return ParallelMakeVector<std::int64_t>(size, std::int64_t{1}, {}, alloc);
+}
+
+// Случайные чтения operator[]: на больших векторах почти каждое обращение
+// промахивается мимо TLB, если страницы обычные
+template <typename Alloc>
+void RandomAccess(benchmark::State& state, const Alloc& alloc) {
+    const auto v = MakeVector(state.range(0), alloc);
+    const size_t mask = v.GetSize() - 1;
+    std::uint64_t seed = 88172645463325252ull;
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (size_t i = 0; i < kAccessesPerIteration; ++i) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            sum += v[(seed >> 20) & mask];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kAccessesPerIteration);
+}
+
+// Зависимые случайные чтения: следующий индекс зависит от прочитанного значения,
+// поэтому замер показывает задержку одного обращения, а не пропускную способность
+template <typename Alloc>
+void DependentAccess(benchmark::State& state, const Alloc& alloc) {
+    auto v = MakeVector(state.range(0), alloc);
+    const size_t mask = v.GetSize() - 1;
+    std::uint64_t seed = 88172645463325252ull;
+    for (size_t i = 0; i < v.GetSize(); ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        v[i] = static_cast<std::int64_t>((seed >> 20) & mask);
+    }
+    for (auto _ : state) {
+        size_t index = 0;
+        for (size_t i = 0; i < kAccessesPerIteration; ++i) {
+            index = static_cast<size_t>(v[index]);
+        }
+        benchmark::DoNotOptimize(index);
+    }
+    state.SetItemsProcessed(state.iterations() * kAccessesPerIteration);
+}
+
+LargePageOptions HugePages() {
+    LargePageOptions options;
+    options.huge_pages = true;
+    return options;
+}
+
+void BM_RandomAccessStdAllocator(benchmark::State& state) {
+    RandomAccess(state, std::allocator<std::int64_t>());
+}
+
+void BM_RandomAccessAligned(benchmark::State& state) {
+    RandomAccess(state, LargePageAllocator<std::int64_t>());
+}
+
+void BM_RandomAccessHugePages(benchmark::State& state) {
+    RandomAccess(state, LargePageAllocator<std::int64_t>(HugePages()));
+}
+
+void BM_DependentAccessStdAllocator(benchmark::State& state) {
+    DependentAccess(state, std::allocator<std::int64_t>());
+}
+
+void BM_DependentAccessHugePages(benchmark::State& state) {
+    DependentAccess(state, LargePageAllocator<std::int64_t>(HugePages()));
+}
+
+// Выделение и параллельное первое заполнение
+void BM_MakeStdAllocator(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MakeVector(state.range(0), std::allocator<std::int64_t>()).begin());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+
+void BM_MakeHugePages(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MakeVector(state.range(0), LargePageAllocator<std::int64_t>(HugePages())).begin());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+
+BENCHMARK(BM_RandomAccessStdAllocator)->RangeMultiplier(16)->Range(1 << 14, 1 << 26);
+BENCHMARK(BM_RandomAccessAligned)->RangeMultiplier(16)->Range(1 << 14, 1 << 26);
+BENCHMARK(BM_RandomAccessHugePages)->RangeMultiplier(16)->Range(1 << 14, 1 << 26);
+BENCHMARK(BM_DependentAccessStdAllocator)->RangeMultiplier(16)->Range(1 << 14, 1 << 26);
+BENCHMARK(BM_DependentAccessHugePages)->RangeMultiplier(16)->Range(1 << 14, 1 << 26);
+BENCHMARK(BM_MakeStdAllocator)->Arg(1 << 24);
+BENCHMARK(BM_MakeHugePages)->Arg(1 << 24);
+
+}  // namespace
+
+BENCHMARK_MAIN();
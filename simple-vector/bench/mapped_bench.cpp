@@ -0,0 +1,107 @@
+#include "../mapped_simple_vector.h"
+#include "../simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+std::string BenchPath(size_t size) {
+    return (std::filesystem::temp_directory_path()
+            / ("mapped_bench_" + std::to_string(::getpid()) + "_" + std::to_string(size) + ".bin"))
+        .string();
+}
+
+// Файл с size элементами; пересоздаётся при смене размера и удаляется при выходе
+struct PreparedFile {
+    std::string path;
+    size_t size = 0;
+
+    ~PreparedFile() {
+        if (!path.empty()) {
+            std::filesystem::remove(path);
+        }
+    }
+};
+
+const std::string& PreparedPath(size_t size) {
+    static PreparedFile file;
+    if (file.path.empty() || file.size != size) {
+        if (!file.path.empty()) {
+            std::filesystem::remove(file.path);
+        }
+        file.path = BenchPath(size);
+        file.size = size;
+        auto v = MappedSimpleVector<std::int64_t>::Create(file.path);
+        v.Resize(size);
+        std::iota(v.begin(), v.end(), 0);
+        v.Flush();
+    }
+    return file.path;
+}
+
+// Перезапуск работника: открыть файл и прочитать один элемент
+void BM_OpenMapped(benchmark::State& state) {
+    const std::string& path = PreparedPath(state.range(0));
+    for (auto _ : state) {
+        auto v = MappedSimpleVector<std::int64_t>::Open(path, MappedSimpleVector<std::int64_t>::Mode::kReadOnly);
+        benchmark::DoNotOptimize(v[v.GetSize() / 2]);
+    }
+}
+
+// Базовая линия: прочитать весь файл в SimpleVector
+void BM_ReloadIntoSimpleVector(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const std::string& path = PreparedPath(size);
+    for (auto _ : state) {
+        SimpleVector<std::int64_t> v(size);
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        std::fseek(file, sizeof(MappedVectorHeader), SEEK_SET);
+        benchmark::DoNotOptimize(std::fread(v.begin(), sizeof(std::int64_t), size, file));
+        std::fclose(file);
+        benchmark::DoNotOptimize(v[size / 2]);
+    }
+}
+
+template <MappedAccess kAccess>
+void BM_MappedScan(benchmark::State& state) {
+    const size_t size = state.range(0);
+    auto v = MappedSimpleVector<std::int64_t>::Open(PreparedPath(size), MappedSimpleVector<std::int64_t>::Mode::kReadOnly);
+    v.Advise(kAccess);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), std::int64_t{0}));
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::int64_t));
+}
+
+void BM_MappedPushBack(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const std::string path = BenchPath(0);
+    for (auto _ : state) {
+        auto v = MappedSimpleVector<std::int64_t>::Create(path);
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(i);
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_OpenMapped)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReloadIntoSimpleVector)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MappedScan, MappedAccess::kNormal)->Range(1 << 16, 1 << 24);
+BENCHMARK_TEMPLATE(BM_MappedScan, MappedAccess::kSequential)->Range(1 << 16, 1 << 24);
+BENCHMARK_TEMPLATE(BM_MappedScan, MappedAccess::kRandom)->Range(1 << 16, 1 << 24);
+BENCHMARK(BM_MappedPushBack)->Range(1 << 10, 1 << 20);
+
+}  // namespace
+
+BENCHMARK_MAIN();
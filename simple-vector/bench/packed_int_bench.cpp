@@ -0,0 +1,121 @@
+#include "../packed_int_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+namespace {
+
+// Аргумент 0 - случайные значения из 12 битов поверх большой базы (kFrameOfReference),
+// аргумент 1 - возрастающие отметки времени с небольшим шагом (kDelta)
+SimpleVector<std::uint64_t> MakeValues(size_t size, int kind) {
+    std::mt19937_64 gen(7);
+    SimpleVector<std::uint64_t> values(Reserve(size));
+    std::uint64_t time = std::uint64_t(1) << 50;
+    for (size_t i = 0; i < size; ++i) {
+        if (kind == 0) {
+            values.PushBack((std::uint64_t(1) << 40) + gen() % 4096);
+        } else {
+            time += gen() % 1000;
+            values.PushBack(time);
+        }
+    }
+    return values;
+}
+
+PackedIntVector<std::uint64_t> MakePacked(const SimpleVector<std::uint64_t>& values) {
+    PackedIntVector<std::uint64_t> packed(Reserve(values.GetSize()));
+    for (std::uint64_t value : values) {
+        packed.PushBack(value);
+    }
+    packed.ShrinkToFit();
+    return packed;
+}
+
+void BM_ScanSimpleVector(benchmark::State& state) {
+    const auto values = MakeValues(state.range(0), state.range(1));
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t value : values) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * values.GetSize());
+    state.counters["bytes_per_value"] = static_cast<double>(values.GetCapacity() * sizeof(std::uint64_t)) / values.GetSize();
+}
+
+void BM_ScanPackedIterator(benchmark::State& state) {
+    const auto packed = MakePacked(MakeValues(state.range(0), state.range(1)));
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t value : packed) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * packed.GetSize());
+    state.counters["bytes_per_value"] = static_cast<double>(packed.GetMemoryUsage()) / packed.GetSize();
+}
+
+// Распаковка блоками в буфер, как при потоковой обработке
+void BM_ScanPackedDecode(benchmark::State& state) {
+    const auto packed = MakePacked(MakeValues(state.range(0), state.range(1)));
+    constexpr size_t kChunk = PackedIntVector<std::uint64_t>::kBlockSize;
+    std::uint64_t buffer[kChunk];
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (size_t first = 0; first < packed.GetSize(); first += kChunk) {
+            const size_t count = std::min(kChunk, packed.GetSize() - first);
+            packed.Decode(first, count, buffer);
+            for (size_t i = 0; i < count; ++i) {
+                sum += buffer[i];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * packed.GetSize());
+    state.counters["bytes_per_value"] = static_cast<double>(packed.GetMemoryUsage()) / packed.GetSize();
+}
+
+void BM_RandomAccessSimpleVector(benchmark::State& state) {
+    const auto values = MakeValues(state.range(0), state.range(1));
+    std::mt19937_64 gen(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(values[gen() % values.GetSize()]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RandomAccessPacked(benchmark::State& state) {
+    const auto packed = MakePacked(MakeValues(state.range(0), state.range(1)));
+    std::mt19937_64 gen(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(packed[gen() % packed.GetSize()]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PushBackPacked(benchmark::State& state) {
+    const auto values = MakeValues(state.range(0), state.range(1));
+    for (auto _ : state) {
+        PackedIntVector<std::uint64_t> packed;
+        for (std::uint64_t value : values) {
+            packed.PushBack(value);
+        }
+        benchmark::DoNotOptimize(packed.GetSize());
+    }
+    state.SetItemsProcessed(state.iterations() * values.GetSize());
+}
+
+BENCHMARK(BM_ScanSimpleVector)->ArgsProduct({{1 << 16, 1 << 24}, {0, 1}});
+BENCHMARK(BM_ScanPackedIterator)->ArgsProduct({{1 << 16, 1 << 24}, {0, 1}});
+BENCHMARK(BM_ScanPackedDecode)->ArgsProduct({{1 << 16, 1 << 24}, {0, 1}});
+BENCHMARK(BM_RandomAccessSimpleVector)->ArgsProduct({{1 << 16, 1 << 24}, {0, 1}});
+BENCHMARK(BM_RandomAccessPacked)->ArgsProduct({{1 << 16, 1 << 24}, {0, 1}});
+BENCHMARK(BM_PushBackPacked)->ArgsProduct({{1 << 16, 1 << 24}, {0, 1}});
+
+}  // namespace
+
+BENCHMARK_MAIN();
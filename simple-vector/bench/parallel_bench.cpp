@@ -0,0 +1,120 @@
+// Сценарии GenerateVector из main.cpp (SimpleVector(size), SimpleVector(size, value), iota)
+// и сортировка, свёртка, поиск на 10^6 и 10^8 элементах: последовательно и через parallel.h
+#include "../parallel.h"
+#include "../simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+void Sizes(benchmark::internal::Benchmark* b) {
+    b->Arg(1'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void BM_SerialGenerateVector(benchmark::State& state) {
+    for (auto _ : state) {
+        SimpleVector<int> v(state.range(0));
+        std::iota(v.begin(), v.end(), 1);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+void BM_ParallelGenerateVector(benchmark::State& state) {
+    for (auto _ : state) {
+        auto v = ParallelMakeVector<int>(state.range(0));
+        ParallelIota(v, 1);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+void BM_SerialFilledVector(benchmark::State& state) {
+    for (auto _ : state) {
+        SimpleVector<int> v(state.range(0), 42);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+void BM_ParallelFilledVector(benchmark::State& state) {
+    for (auto _ : state) {
+        auto v = ParallelMakeVector<int>(state.range(0), 42);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+SimpleVector<std::uint32_t> Shuffled(size_t size) {
+    SimpleVector<std::uint32_t> v(size);
+    std::uint32_t x = 12345;
+    for (auto& item : v) {
+        x = x * 1664525u + 1013904223u;
+        item = x;
+    }
+    return v;
+}
+
+void BM_SerialSort(benchmark::State& state) {
+    const auto source = Shuffled(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto v = source;
+        state.ResumeTiming();
+        std::sort(v.begin(), v.end());
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+void BM_ParallelSort(benchmark::State& state) {
+    const auto source = Shuffled(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto v = source;
+        state.ResumeTiming();
+        ParallelSort(v);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+void BM_SerialReduce(benchmark::State& state) {
+    const auto v = Shuffled(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), std::uint64_t{0}));
+    }
+}
+
+void BM_ParallelReduce(benchmark::State& state) {
+    const auto v = Shuffled(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ParallelReduce(v, std::uint64_t{0}));
+    }
+}
+
+void BM_SerialFindMissing(benchmark::State& state) {
+    SimpleVector<int> v(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(v.begin(), v.end(), 2));
+    }
+}
+
+void BM_ParallelFindMissing(benchmark::State& state) {
+    SimpleVector<int> v(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ParallelFind(v, 2));
+    }
+}
+
+BENCHMARK(BM_SerialGenerateVector)->Apply(Sizes);
+BENCHMARK(BM_ParallelGenerateVector)->Apply(Sizes);
+BENCHMARK(BM_SerialFilledVector)->Apply(Sizes);
+BENCHMARK(BM_ParallelFilledVector)->Apply(Sizes);
+BENCHMARK(BM_SerialSort)->Apply(Sizes);
+BENCHMARK(BM_ParallelSort)->Apply(Sizes);
+BENCHMARK(BM_SerialReduce)->Apply(Sizes);
+BENCHMARK(BM_ParallelReduce)->Apply(Sizes);
+BENCHMARK(BM_SerialFindMissing)->Apply(Sizes);
+BENCHMARK(BM_ParallelFindMissing)->Apply(Sizes);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#include "../persistent_simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+SimpleVector<std::int64_t> MakeVector(size_t size) {
+    SimpleVector<std::int64_t> v(size);
+    std::iota(v.begin(), v.end(), 0);
+    return v;
+}
+
+// Снимок состояния: полная копия SimpleVector против O(1) копии
+void BM_CopySimpleVector(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    for (auto _ : state) {
+        SimpleVector<std::int64_t> copy = v;
+        benchmark::DoNotOptimize(copy.begin());
+    }
+}
+
+void BM_CopyPersistent(benchmark::State& state) {
+    const PersistentSimpleVector<std::int64_t> v(MakeVector(state.range(0)));
+    for (auto _ : state) {
+        PersistentSimpleVector<std::int64_t> copy = v;
+        benchmark::DoNotOptimize(copy.GetSize());
+    }
+}
+
+// Копия с последующим изменением одного элемента: типичное обновление снимка
+void BM_CopyAndSetSimpleVector(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    size_t index = 0;
+    for (auto _ : state) {
+        SimpleVector<std::int64_t> copy = v;
+        copy[index] = -1;
+        index = (index + 7919) % v.GetSize();
+        benchmark::DoNotOptimize(copy.begin());
+    }
+}
+
+void BM_CopyAndSetPersistent(benchmark::State& state) {
+    const PersistentSimpleVector<std::int64_t> v(MakeVector(state.range(0)));
+    size_t index = 0;
+    for (auto _ : state) {
+        PersistentSimpleVector<std::int64_t> copy = v;
+        copy.Set(index, -1);
+        index = (index + 7919) % v.GetSize();
+        benchmark::DoNotOptimize(copy.GetSize());
+    }
+}
+
+void BM_PushBackPersistent(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        PersistentSimpleVector<std::int64_t> v;
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(i);
+        }
+        benchmark::DoNotOptimize(v.GetSize());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_IterateSimpleVector(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), std::int64_t{0}));
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_IteratePersistent(benchmark::State& state) {
+    const PersistentSimpleVector<std::int64_t> v(MakeVector(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), std::int64_t{0}));
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_ToSimpleVector(benchmark::State& state) {
+    const PersistentSimpleVector<std::int64_t> v(MakeVector(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v.ToSimpleVector().begin());
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+BENCHMARK(BM_CopySimpleVector)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_CopyPersistent)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_CopyAndSetSimpleVector)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_CopyAndSetPersistent)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_PushBackPersistent)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IterateSimpleVector)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_IteratePersistent)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_ToSimpleVector)->Range(1 << 10, 1 << 22);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+#include "../recycling_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+// Обработчик запроса: несколько короткоживущих векторов разного размера,
+// заполняемых через PushBack с ростом буфера
+template <typename Vector>
+std::uint64_t HandleRequest(size_t size) {
+    Vector ids;
+    Vector scores;
+    for (size_t i = 0; i < size; ++i) {
+        ids.PushBack(i);
+        if (i % 4 == 0) {
+            scores.PushBack(i * 3);
+        }
+    }
+    Vector merged(Reserve(ids.GetSize() + scores.GetSize()));
+    for (std::uint64_t id : ids) {
+        merged.PushBack(id);
+    }
+    for (std::uint64_t score : scores) {
+        merged.PushBack(score);
+    }
+    return merged[merged.GetSize() / 2];
+}
+
+void BM_RequestStdAllocator(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(HandleRequest<SimpleVector<std::uint64_t>>(state.range(0)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RequestRecycling(benchmark::State& state) {
+    const RecyclerStats before = BufferRecycler::Instance().GetStats();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(HandleRequest<recycling::SimpleVector<std::uint64_t>>(state.range(0)));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        const RecyclerStats after = BufferRecycler::Instance().GetStats();
+        const double hits = static_cast<double>(after.thread_hits + after.global_hits - before.thread_hits - before.global_hits);
+        state.counters["hit_rate"] = hits / (hits + after.misses - before.misses);
+        state.counters["retained_kb"] = after.retained_bytes / 1024.0;
+    }
+}
+
+// Один вектор на обращение: чистая стоимость выделения и освобождения
+void BM_AllocateStdAllocator(benchmark::State& state) {
+    for (auto _ : state) {
+        SimpleVector<char> v(Reserve(state.range(0)));
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_AllocateRecycling(benchmark::State& state) {
+    for (auto _ : state) {
+        recycling::SimpleVector<char> v(Reserve(state.range(0)));
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RequestStdAllocator)->Arg(16)->Arg(256)->Arg(4096)->Threads(1)->Threads(4);
+BENCHMARK(BM_RequestRecycling)->Arg(16)->Arg(256)->Arg(4096)->Threads(1)->Threads(4);
+BENCHMARK(BM_AllocateStdAllocator)->Arg(64)->Arg(4096)->Arg(256 << 10);
+BENCHMARK(BM_AllocateRecycling)->Arg(64)->Arg(4096)->Arg(256 << 10);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,129 @@
+#include "../simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+struct Pod64 {
+    std::uint64_t words[8];
+};
+
+// Тот же 64-байтный POD, но с отключённым побайтовым переносом:
+// базовая линия для поэлементного перемещения
+struct ElementwisePod64 {
+    std::uint64_t words[8];
+};
+
+struct ElementwiseInt {
+    int value;
+};
+
+// Дескриптор, владеющий ресурсом и обнуляющий источник при перемещении
+class Handle {
+public:
+    Handle() = default;
+    Handle(Handle&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)) {
+    }
+    Handle& operator=(Handle&& other) noexcept {
+        std::swap(data_, other.data_);
+        return *this;
+    }
+    ~Handle() {
+        delete data_;
+    }
+
+private:
+    int* data_ = nullptr;
+};
+
+// Такой же дескриптор, объявленный тривиально переносимым
+class RelocatableHandle : public Handle {
+};
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<RelocatableHandle> : std::true_type {
+};
+
+template <>
+struct IsTriviallyRelocatable<ElementwisePod64> : std::false_type {
+};
+
+template <>
+struct IsTriviallyRelocatable<ElementwiseInt> : std::false_type {
+};
+
+namespace {
+
+template <typename Type>
+void BM_PushBackGrowth(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        SimpleVector<Type> v;
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(Type{});
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Type>
+void BM_InsertFront(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        SimpleVector<Type> v(Reserve(size));
+        for (size_t i = 0; i < size; ++i) {
+            v.Insert(v.begin(), Type{});
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Type>
+void BM_EraseFront(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        SimpleVector<Type> v(size);
+        state.ResumeTiming();
+        while (!v.IsEmpty()) {
+            v.Erase(v.begin());
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK_TEMPLATE(BM_PushBackGrowth, int)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBackGrowth, ElementwiseInt)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBackGrowth, Pod64)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBackGrowth, ElementwisePod64)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(BM_PushBackGrowth, Handle)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBackGrowth, RelocatableHandle)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(BM_InsertFront, int)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_InsertFront, ElementwiseInt)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_InsertFront, Pod64)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_InsertFront, ElementwisePod64)->Range(1 << 8, 1 << 14);
+
+BENCHMARK_TEMPLATE(BM_InsertFront, Handle)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_InsertFront, RelocatableHandle)->Range(1 << 8, 1 << 14);
+
+BENCHMARK_TEMPLATE(BM_EraseFront, int)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseFront, ElementwiseInt)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseFront, Pod64)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseFront, ElementwisePod64)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseFront, Handle)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseFront, RelocatableHandle)->Range(1 << 8, 1 << 14);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,141 @@
+#include "../serialization.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+const std::string& BenchPath() {
+    static const std::string path =
+        (std::filesystem::temp_directory_path() / ("serialization_bench_" + std::to_string(::getpid()) + ".bin"))
+            .string();
+    return path;
+}
+
+SimpleVector<std::int64_t> MakeVector(size_t size) {
+    SimpleVector<std::int64_t> v(size);
+    std::iota(v.begin(), v.end(), 0);
+    return v;
+}
+
+void BM_Serialize(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    for (auto _ : state) {
+        std::ofstream out(BenchPath(), std::ios::binary | std::ios::trunc);
+        Serialize(v, out);
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(std::int64_t));
+}
+
+// Базовая линия: запись по одному элементу
+void BM_SerializeNaive(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    for (auto _ : state) {
+        std::ofstream out(BenchPath(), std::ios::binary | std::ios::trunc);
+        const std::uint64_t size = v.GetSize();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        for (const std::int64_t& x : v) {
+            out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(std::int64_t));
+}
+
+void BM_Deserialize(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    {
+        std::ofstream out(BenchPath(), std::ios::binary | std::ios::trunc);
+        Serialize(v, out);
+    }
+    for (auto _ : state) {
+        std::ifstream in(BenchPath(), std::ios::binary);
+        benchmark::DoNotOptimize(Deserialize<std::int64_t>(in).GetSize());
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(std::int64_t));
+}
+
+// Базовая линия: чтение по одному элементу с PushBack
+void BM_DeserializeNaive(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    {
+        std::ofstream out(BenchPath(), std::ios::binary | std::ios::trunc);
+        const std::uint64_t size = v.GetSize();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(v.begin()), size * sizeof(std::int64_t));
+    }
+    for (auto _ : state) {
+        std::ifstream in(BenchPath(), std::ios::binary);
+        std::uint64_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        SimpleVector<std::int64_t> result;
+        for (std::uint64_t i = 0; i < size; ++i) {
+            std::int64_t x;
+            in.read(reinterpret_cast<char*>(&x), sizeof(x));
+            result.PushBack(x);
+        }
+        benchmark::DoNotOptimize(result.GetSize());
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(std::int64_t));
+}
+
+// Потоковое чтение кусками фиксированного размера: память не зависит от размера данных
+void BM_StreamRead(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    {
+        std::ofstream out(BenchPath(), std::ios::binary | std::ios::trunc);
+        VectorStreamWriter<std::int64_t> writer(out);
+        for (size_t pos = 0; pos < v.GetSize(); pos += 1 << 16) {
+            writer.Write(v.begin() + pos, std::min<size_t>(1 << 16, v.GetSize() - pos));
+        }
+        writer.Finish();
+    }
+    SimpleVector<std::int64_t> chunk;
+    for (auto _ : state) {
+        std::ifstream in(BenchPath(), std::ios::binary);
+        VectorStreamReader<std::int64_t> reader(in);
+        std::int64_t sum = 0;
+        while (reader.ReadChunk(chunk, 1 << 16)) {
+            sum += chunk[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(std::int64_t));
+}
+
+void BM_Checksum(benchmark::State& state) {
+    const auto v = MakeVector(state.range(0));
+    for (auto _ : state) {
+        VectorChecksum checksum;
+        checksum.Update(v.begin(), v.GetSize() * sizeof(std::int64_t));
+        benchmark::DoNotOptimize(checksum.Finish());
+    }
+    state.SetBytesProcessed(state.iterations() * v.GetSize() * sizeof(std::int64_t));
+}
+
+// Путь создаётся раньше этого объекта, поэтому ещё существует в его деструкторе
+struct RemoveBenchFile {
+    RemoveBenchFile() {
+        BenchPath();
+    }
+    ~RemoveBenchFile() {
+        std::filesystem::remove(BenchPath());
+    }
+} remove_bench_file;
+
+BENCHMARK(BM_Serialize)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_SerializeNaive)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_Deserialize)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_DeserializeNaive)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_StreamRead)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_Checksum)->Range(1 << 10, 1 << 24);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,325 @@
+// Замеры всех основных операций SimpleVector с std::vector в качестве базовой линии.
+// Каждая операция прогоняется на int, std::string и 256-байтном POD для размеров
+// от 1 до 10^8; размеры, при которых один вектор занял бы больше kMaxBytes, пропускаются
+#include "../simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t kMaxSize = 100'000'000;
+constexpr size_t kMaxBytes = size_t(1) << 30;
+
+struct LargePod {
+    std::uint64_t words[32];
+};
+
+bool operator==(const LargePod& lhs, const LargePod& rhs) {
+    return std::equal(std::begin(lhs.words), std::end(lhs.words), std::begin(rhs.words));
+}
+
+bool operator<(const LargePod& lhs, const LargePod& rhs) {
+    return std::lexicographical_compare(std::begin(lhs.words), std::end(lhs.words),
+                                        std::begin(rhs.words), std::end(rhs.words));
+}
+
+template <typename Type>
+Type MakeValue(size_t i);
+
+template <>
+int MakeValue<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+// Строки длиннее буфера SSO, чтобы копирование действительно выделяло память
+template <>
+std::string MakeValue<std::string>(size_t i) {
+    return std::string(24, 'a') + std::to_string(i);
+}
+
+template <>
+LargePod MakeValue<LargePod>(size_t i) {
+    LargePod pod{};
+    pod.words[0] = i;
+    return pod;
+}
+
+// Примерный объём одного элемента вместе с памятью, которой он владеет
+template <typename Type>
+constexpr size_t kElementBytes = sizeof(Type);
+
+template <>
+constexpr size_t kElementBytes<std::string> = sizeof(std::string) + 48;
+
+// Размеры 1, 10, ..., 10^8 в пределах kMaxBytes на вектор
+template <typename Type>
+void Sizes(benchmark::internal::Benchmark* b) {
+    for (size_t size = 1; size <= kMaxSize && size * kElementBytes<Type> <= kMaxBytes; size *= 10) {
+        b->Arg(static_cast<int64_t>(size));
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+// Единый интерфейс для SimpleVector и std::vector
+
+template <typename Type>
+void PushBack(SimpleVector<Type>& v, const Type& value) {
+    v.PushBack(value);
+}
+
+template <typename Type>
+void PushBack(SimpleVector<Type>& v, Type&& value) {
+    v.PushBack(std::move(value));
+}
+
+template <typename Type>
+void PushBack(std::vector<Type>& v, const Type& value) {
+    v.push_back(value);
+}
+
+template <typename Type>
+void PushBack(std::vector<Type>& v, Type&& value) {
+    v.push_back(std::move(value));
+}
+
+template <typename Type>
+void Insert(SimpleVector<Type>& v, size_t index, const Type& value) {
+    v.Insert(v.begin() + index, value);
+}
+
+template <typename Type>
+void Insert(std::vector<Type>& v, size_t index, const Type& value) {
+    v.insert(v.begin() + index, value);
+}
+
+template <typename Type>
+void Erase(SimpleVector<Type>& v, size_t index) {
+    v.Erase(v.begin() + index);
+}
+
+template <typename Type>
+void Erase(std::vector<Type>& v, size_t index) {
+    v.erase(v.begin() + index);
+}
+
+template <typename Type>
+void PopBack(SimpleVector<Type>& v) {
+    v.PopBack();
+}
+
+template <typename Type>
+void PopBack(std::vector<Type>& v) {
+    v.pop_back();
+}
+
+template <typename Type>
+void Resize(SimpleVector<Type>& v, size_t size) {
+    v.Resize(size);
+}
+
+template <typename Type>
+void Resize(std::vector<Type>& v, size_t size) {
+    v.resize(size);
+}
+
+template <typename Type>
+void Reserve(SimpleVector<Type>& v, size_t size) {
+    v.Reserve(size);
+}
+
+template <typename Type>
+void Reserve(std::vector<Type>& v, size_t size) {
+    v.reserve(size);
+}
+
+template <typename Vector>
+Vector MakeVector(size_t size) {
+    using Type = std::decay_t<decltype(*std::declval<Vector&>().begin())>;
+    Vector v;
+    Reserve(v, size);
+    for (size_t i = 0; i < size; ++i) {
+        PushBack(v, MakeValue<Type>(i));
+    }
+    return v;
+}
+
+template <typename Vector>
+using ValueOf = std::decay_t<decltype(*std::declval<Vector&>().begin())>;
+
+template <typename Vector>
+void BM_PushBackCopy(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const ValueOf<Vector> value = MakeValue<ValueOf<Vector>>(size);
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(v, value);
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Vector>
+void BM_PushBackMove(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(v, MakeValue<ValueOf<Vector>>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Одна вставка в вектор из size элементов; PopBack возвращает размер обратно за O(1)
+template <typename Vector>
+void InsertAt(benchmark::State& state, size_t numerator, size_t denominator) {
+    const size_t size = state.range(0);
+    Vector v = MakeVector<Vector>(size);
+    Reserve(v, size + 1);
+    const ValueOf<Vector> value = MakeValue<ValueOf<Vector>>(size);
+    const size_t index = size * numerator / denominator;
+    for (auto _ : state) {
+        Insert(v, index, value);
+        PopBack(v);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+template <typename Vector>
+void BM_InsertFront(benchmark::State& state) {
+    InsertAt<Vector>(state, 0, 1);
+}
+
+template <typename Vector>
+void BM_InsertMiddle(benchmark::State& state) {
+    InsertAt<Vector>(state, 1, 2);
+}
+
+template <typename Vector>
+void BM_InsertBack(benchmark::State& state) {
+    InsertAt<Vector>(state, 1, 1);
+}
+
+// Одно удаление из начала вектора из size элементов; PushBack возвращает размер обратно
+template <typename Vector>
+void BM_EraseFront(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Vector v = MakeVector<Vector>(size);
+    const ValueOf<Vector> value = MakeValue<ValueOf<Vector>>(size);
+    for (auto _ : state) {
+        Erase(v, 0);
+        PushBack(v, value);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+template <typename Vector>
+void BM_Resize(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        Resize(v, size);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Vector>
+void BM_Reserve(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        Reserve(v, size);
+        benchmark::DoNotOptimize(v.begin());
+    }
+}
+
+template <typename Vector>
+void BM_CopyConstruct(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Vector source = MakeVector<Vector>(size);
+    for (auto _ : state) {
+        Vector copy(source);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Vector>
+void BM_MoveConstruct(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Vector source = MakeVector<Vector>(size);
+    for (auto _ : state) {
+        Vector moved(std::move(source));
+        benchmark::DoNotOptimize(moved.begin());
+        source = std::move(moved);
+    }
+}
+
+// Равные векторы - худший случай: сравнение просматривает все элементы
+template <typename Vector>
+void BM_Equal(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Vector lhs = MakeVector<Vector>(size);
+    const Vector rhs = MakeVector<Vector>(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Vector>
+void BM_Less(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Vector lhs = MakeVector<Vector>(size);
+    const Vector rhs = MakeVector<Vector>(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs < rhs);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Vector>
+void BM_LessEqual(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Vector lhs = MakeVector<Vector>(size);
+    const Vector rhs = MakeVector<Vector>(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs <= rhs);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+#define SIMPLE_VECTOR_BENCH_TYPE(bench, Type)                                      \
+    BENCHMARK_TEMPLATE(bench, SimpleVector<Type>)->Apply(Sizes<Type>);            \
+    BENCHMARK_TEMPLATE(bench, std::vector<Type>)->Apply(Sizes<Type>)
+
+#define SIMPLE_VECTOR_BENCH(bench)                                                 \
+    SIMPLE_VECTOR_BENCH_TYPE(bench, int);                                          \
+    SIMPLE_VECTOR_BENCH_TYPE(bench, std::string);                                  \
+    SIMPLE_VECTOR_BENCH_TYPE(bench, LargePod)
+
+SIMPLE_VECTOR_BENCH(BM_PushBackCopy);
+SIMPLE_VECTOR_BENCH(BM_PushBackMove);
+SIMPLE_VECTOR_BENCH(BM_InsertFront);
+SIMPLE_VECTOR_BENCH(BM_InsertMiddle);
+SIMPLE_VECTOR_BENCH(BM_InsertBack);
+SIMPLE_VECTOR_BENCH(BM_EraseFront);
+SIMPLE_VECTOR_BENCH(BM_Resize);
+SIMPLE_VECTOR_BENCH(BM_Reserve);
+SIMPLE_VECTOR_BENCH(BM_CopyConstruct);
+SIMPLE_VECTOR_BENCH(BM_MoveConstruct);
+SIMPLE_VECTOR_BENCH(BM_Equal);
+SIMPLE_VECTOR_BENCH(BM_Less);
+SIMPLE_VECTOR_BENCH(BM_LessEqual);
+
+}  // namespace
+
+BENCHMARK_MAIN();
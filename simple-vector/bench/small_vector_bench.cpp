@@ -0,0 +1,187 @@
+#include "../simple_vector.h"
+#include "../small_simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<size_t> allocation_count{0};
+
+// Выделение и освобождение вынесены в невстраиваемые функции: иначе компилятор видит
+// free прямо в месте вызова delete для памяти из new и предупреждает о несовпадении пар
+__attribute__((noinline)) void* CountedAllocate(size_t size, size_t alignment) noexcept {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    size = size == 0 ? 1 : size;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+__attribute__((noinline)) void CountedFree(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void* CountedAllocateOrThrow(size_t size, size_t alignment) {
+    if (void* ptr = CountedAllocate(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+// Считаем все выделения памяти в куче, чтобы сравнить их число на итерацию.
+// Заменяется всё семейство operator new и operator delete, включая массивы и выравнивание
+void* operator new(size_t size) {
+    return CountedAllocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size) {
+    return CountedAllocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return CountedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return CountedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    CountedFree(ptr);
+}
+
+namespace {
+
+constexpr size_t kInline = 8;
+
+template <typename Vector>
+void BM_FillSmall(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const size_t allocations_before = allocation_count.load();
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+        static_cast<double>(allocation_count.load() - allocations_before) / state.iterations());
+}
+
+template <typename Vector>
+void BM_InsertEraseSmall(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const size_t allocations_before = allocation_count.load();
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < size; ++i) {
+            v.Insert(v.begin(), static_cast<int>(i));
+        }
+        while (!v.IsEmpty()) {
+            v.Erase(v.begin());
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+        static_cast<double>(allocation_count.load() - allocations_before) / state.iterations());
+}
+
+template <typename Vector>
+void BM_CopySmall(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Vector source;
+    for (size_t i = 0; i < size; ++i) {
+        source.PushBack(static_cast<int>(i));
+    }
+    const size_t allocations_before = allocation_count.load();
+    for (auto _ : state) {
+        Vector copy(source);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+        static_cast<double>(allocation_count.load() - allocations_before) / state.iterations());
+}
+
+using Plain = SimpleVector<int>;
+using Small = SmallSimpleVector<int, kInline>;
+
+BENCHMARK_TEMPLATE(BM_FillSmall, Plain)->DenseRange(1, kInline);
+BENCHMARK_TEMPLATE(BM_FillSmall, Small)->DenseRange(1, kInline);
+BENCHMARK_TEMPLATE(BM_InsertEraseSmall, Plain)->DenseRange(1, kInline);
+BENCHMARK_TEMPLATE(BM_InsertEraseSmall, Small)->DenseRange(1, kInline);
+BENCHMARK_TEMPLATE(BM_CopySmall, Plain)->DenseRange(1, kInline);
+BENCHMARK_TEMPLATE(BM_CopySmall, Small)->DenseRange(1, kInline);
+
+}  // namespace
+
+BENCHMARK_MAIN();
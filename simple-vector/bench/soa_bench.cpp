@@ -0,0 +1,129 @@
+#include "../soa_simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+// Широкая запись: горячие поля price и quantity занимают 16 байт из 64
+struct Record {
+    std::int64_t id;
+    double price;
+    double quantity;
+    char payload[40];
+};
+
+using RecordColumns = SoASimpleVector<std::int64_t, double, double, std::array<char, 40>>;
+
+SimpleVector<Record> MakeAoS(size_t size) {
+    SimpleVector<Record> v(size);
+    for (size_t i = 0; i < size; ++i) {
+        v[i].id = i;
+        v[i].price = i * 0.25;
+        v[i].quantity = i % 7;
+    }
+    return v;
+}
+
+RecordColumns MakeSoA(size_t size) {
+    RecordColumns v(Reserve(size));
+    for (size_t i = 0; i < size; ++i) {
+        v.PushBack(i, i * 0.25, i % 7, {});
+    }
+    return v;
+}
+
+void BM_SumFieldAoS(benchmark::State& state) {
+    const auto v = MakeAoS(state.range(0));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const Record& r : v) {
+            sum += r.price;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_SumFieldSoA(benchmark::State& state) {
+    const auto v = MakeSoA(state.range(0));
+    for (auto _ : state) {
+        const auto prices = v.Column<1>();
+        benchmark::DoNotOptimize(std::accumulate(prices.begin(), prices.end(), 0.0));
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_SumTwoFieldsAoS(benchmark::State& state) {
+    const auto v = MakeAoS(state.range(0));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const Record& r : v) {
+            sum += r.price * r.quantity;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_SumTwoFieldsSoA(benchmark::State& state) {
+    const auto v = MakeSoA(state.range(0));
+    for (auto _ : state) {
+        const auto prices = v.Column<1>();
+        const auto quantities = v.Column<2>();
+        benchmark::DoNotOptimize(std::inner_product(prices.begin(), prices.end(), quantities.begin(), 0.0));
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+// Обход через прокси-итератор строк: цена удобства по сравнению с прямым доступом к столбцу
+void BM_SumFieldSoAZip(benchmark::State& state) {
+    const auto v = MakeSoA(state.range(0));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const auto& [id, price, quantity, payload] : v) {
+            sum += price;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * v.GetSize());
+}
+
+void BM_PushBackAoS(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        SimpleVector<Record> v;
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(Record{static_cast<std::int64_t>(i), i * 0.25, 1.0, {}});
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_PushBackSoA(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        RecordColumns v;
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(i, i * 0.25, 1.0, {});
+        }
+        benchmark::DoNotOptimize(v.Column<0>().Data());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_SumFieldAoS)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_SumFieldSoA)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_SumFieldSoAZip)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_SumTwoFieldsAoS)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_SumTwoFieldsSoA)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_PushBackAoS)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PushBackSoA)->Range(1 << 10, 1 << 20);
+
+}  // namespace
+
+BENCHMARK_MAIN();
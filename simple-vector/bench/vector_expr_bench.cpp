@@ -0,0 +1,115 @@
+#include "../vector_expr.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace {
+
+SimpleVector<double> MakeValues(size_t size, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    SimpleVector<double> values(size);
+    for (double& value : values) {
+        value = dist(gen);
+    }
+    return values;
+}
+
+// Каждый шаг - отдельный проход и новый вектор
+SimpleVector<double> Scale(const SimpleVector<double>& a, double factor) {
+    SimpleVector<double> result(a.GetSize());
+    for (size_t i = 0; i < a.GetSize(); ++i) {
+        result[i] = a[i] * factor;
+    }
+    return result;
+}
+
+SimpleVector<double> Add(const SimpleVector<double>& a, const SimpleVector<double>& b) {
+    SimpleVector<double> result(a.GetSize());
+    for (size_t i = 0; i < a.GetSize(); ++i) {
+        result[i] = a[i] + b[i];
+    }
+    return result;
+}
+
+SimpleVector<double> Subtract(const SimpleVector<double>& a, const SimpleVector<double>& b) {
+    SimpleVector<double> result(a.GetSize());
+    for (size_t i = 0; i < a.GetSize(); ++i) {
+        result[i] = a[i] - b[i];
+    }
+    return result;
+}
+
+// d = a * 2 + b - c
+void BM_Temporaries(benchmark::State& state) {
+    const auto a = MakeValues(state.range(0), 1);
+    const auto b = MakeValues(state.range(0), 2);
+    const auto c = MakeValues(state.range(0), 3);
+    SimpleVector<double> d(state.range(0));
+    for (auto _ : state) {
+        d = Subtract(Add(Scale(a, 2.0), b), c);
+        benchmark::DoNotOptimize(d.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+void BM_HandWrittenLoop(benchmark::State& state) {
+    const auto a = MakeValues(state.range(0), 1);
+    const auto b = MakeValues(state.range(0), 2);
+    const auto c = MakeValues(state.range(0), 3);
+    SimpleVector<double> d(state.range(0));
+    for (auto _ : state) {
+        for (size_t i = 0; i < d.GetSize(); ++i) {
+            d[i] = a[i] * 2.0 + b[i] - c[i];
+        }
+        benchmark::DoNotOptimize(d.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+void BM_Expression(benchmark::State& state) {
+    const auto a = MakeValues(state.range(0), 1);
+    const auto b = MakeValues(state.range(0), 2);
+    const auto c = MakeValues(state.range(0), 3);
+    SimpleVector<double> d(state.range(0));
+    for (auto _ : state) {
+        d = a * 2.0 + b - c;
+        benchmark::DoNotOptimize(d.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+// Норма разности: свёртка выражения без промежуточного вектора
+void BM_NormTemporaries(benchmark::State& state) {
+    const auto a = MakeValues(state.range(0), 1);
+    const auto b = MakeValues(state.range(0), 2);
+    for (auto _ : state) {
+        const auto diff = Subtract(a, b);
+        double sum = 0.0;
+        for (double value : diff) {
+            sum += value * value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+void BM_NormExpression(benchmark::State& state) {
+    const auto a = MakeValues(state.range(0), 1);
+    const auto b = MakeValues(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Sum((a - b) * (a - b)));
+    }
+    state.SetItemsProcessed(state.iterations() * a.GetSize());
+}
+
+BENCHMARK(BM_Temporaries)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_HandWrittenLoop)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_Expression)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_NormTemporaries)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_NormExpression)->Range(1 << 10, 1 << 22);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,81 @@
+#include "../simple_vector_view.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+// Кадр фиксированной длины внутри большого буфера: копия против среза
+void BM_FrameCopy(benchmark::State& state) {
+    SimpleVector<std::uint8_t> packet(1 << 20);
+    std::iota(packet.begin(), packet.end(), 0);
+    const size_t frame = state.range(0);
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (size_t offset = 0; offset + frame <= packet.GetSize(); offset += frame) {
+            SimpleVector<std::uint8_t> copy(packet.begin() + offset, packet.begin() + offset + frame);
+            sum += copy[0] + copy[frame - 1];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * packet.GetSize());
+}
+
+void BM_FrameView(benchmark::State& state) {
+    SimpleVector<std::uint8_t> packet(1 << 20);
+    std::iota(packet.begin(), packet.end(), 0);
+    const size_t frame = state.range(0);
+    for (auto _ : state) {
+        const SimpleVectorView<const std::uint8_t> all = packet;
+        std::uint64_t sum = 0;
+        for (size_t offset = 0; offset + frame <= all.GetSize(); offset += frame) {
+            const auto view = all.Subview(offset, frame);
+            sum += view[0] + view[frame - 1];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * packet.GetSize());
+}
+
+// Декодер отдаёт буфер из malloc: копирование в вектор против передачи владения
+std::uint32_t* Decode(size_t size) {
+    auto* data = static_cast<std::uint32_t*>(std::malloc(size * sizeof(std::uint32_t)));
+    std::memset(data, 1, size * sizeof(std::uint32_t));
+    return data;
+}
+
+void BM_DecodedCopy(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        std::uint32_t* data = Decode(size);
+        SimpleVector<std::uint32_t> v(data, data + size);
+        std::free(data);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+}
+
+void BM_DecodedAdopt(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        SimpleVector<std::uint32_t> v;
+        v.Adopt(Decode(size), size, size, [](void*, std::uint32_t* data, size_t) {
+            std::free(data);
+        });
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+}
+
+BENCHMARK(BM_FrameCopy)->Arg(64)->Arg(1500)->Arg(16 << 10);
+BENCHMARK(BM_FrameView)->Arg(64)->Arg(1500)->Arg(16 << 10);
+BENCHMARK(BM_DecodedCopy)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_DecodedAdopt)->Range(1 << 10, 1 << 22);
+
+}  // namespace
+
+BENCHMARK_MAIN();
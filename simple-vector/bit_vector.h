@@ -0,0 +1,356 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include "simd.h"
+#include "simple_vector.h"
+
+// Вектор битов: 64 флага в одном слове вместо байта на флаг у SimpleVector<bool>.
+// Биты хранятся в SimpleVector<uint64_t> от младшего к старшему, бит i лежит
+// в слове i / 64. Биты последнего слова за пределами размера всегда нулевые,
+// поэтому подсчёт, сравнение и поиск работают целыми словами.
+// Побитовые операции и подсчёт единиц идут через векторизованные ядра simd.h
+class BitVector {
+public:
+    using Word = std::uint64_t;
+    static constexpr size_t kWordBits = 64;
+
+    // Ссылка на отдельный бит
+    class Reference {
+    public:
+        Reference(Word* word, Word mask) noexcept
+            : word_(word)
+            , mask_(mask) {
+        }
+
+        Reference(const Reference&) = default;
+
+        operator bool() const noexcept {
+            return (*word_ & mask_) != 0;
+        }
+
+        Reference& operator=(bool value) noexcept {
+            if (value) {
+                *word_ |= mask_;
+            } else {
+                *word_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        // Присваивает значение бита, а не перенацеливает ссылку
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        void Flip() noexcept {
+            *word_ ^= mask_;
+        }
+
+    private:
+        Word* word_;
+        Word mask_;
+    };
+
+    BitVector() noexcept = default;
+
+    explicit BitVector(size_t size, bool value = false) {
+        Resize(size, value);
+    }
+
+    BitVector(std::initializer_list<bool> init) {
+        Reserve(init.size());
+        for (bool bit : init) {
+            PushBack(bit);
+        }
+    }
+
+    // Резервирует место под capacity битов
+    BitVector(ReserveProxyObj Rpo) {
+        Reserve(Rpo.GetRes());
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Вместимость в битах
+    size_t GetCapacity() const noexcept {
+        return words_.GetCapacity() * kWordBits;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return {&words_[index / kWordBits], Mask(index)};
+    }
+
+    bool operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return (words_[index / kWordBits] & Mask(index)) != 0;
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return (*this)[index];
+    }
+
+    bool At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return (*this)[index];
+    }
+
+    void Set(size_t index, bool value = true) noexcept {
+        (*this)[index] = value;
+    }
+
+    void Reset(size_t index) noexcept {
+        (*this)[index] = false;
+    }
+
+    void Flip(size_t index) noexcept {
+        (*this)[index].Flip();
+    }
+
+    void PushBack(bool value) {
+        if (size_ % kWordBits == 0) {
+            words_.PushBack(value ? 1 : 0);
+        } else if (value) {
+            words_[size_ / kWordBits] |= Mask(size_);
+        }
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        if (size_ % kWordBits == 0) {
+            words_.PopBack();
+        } else {
+            words_[size_ / kWordBits] &= ~Mask(size_);
+        }
+    }
+
+    // Изменяет размер; новые биты получают значение value
+    void Resize(size_t new_size, bool value = false) {
+        const size_t old_size = size_;
+        const size_t old_words = words_.GetSize();
+        words_.Resize(WordCount(new_size));
+        if (new_size > old_size && value) {
+            if (old_size % kWordBits != 0) {
+                words_[old_words - 1] |= ~Word(0) << (old_size % kWordBits);
+            }
+            std::fill(words_.begin() + old_words, words_.end(), ~Word(0));
+        }
+        size_ = new_size;
+        ClearTail();
+    }
+
+    // Резервирует место под capacity битов
+    void Reserve(size_t capacity) {
+        words_.Reserve(WordCount(capacity));
+    }
+
+    void Clear() noexcept {
+        words_.Clear();
+        size_ = 0;
+    }
+
+    void swap(BitVector& other) noexcept {
+        words_.swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    // Побитовые операции с вектором того же размера
+    BitVector& And(const BitVector& other) noexcept {
+        return Apply<simd::BitOp::kAnd>(other);
+    }
+
+    BitVector& Or(const BitVector& other) noexcept {
+        return Apply<simd::BitOp::kOr>(other);
+    }
+
+    BitVector& Xor(const BitVector& other) noexcept {
+        return Apply<simd::BitOp::kXor>(other);
+    }
+
+    // Сбрасывает биты, установленные в other
+    BitVector& AndNot(const BitVector& other) noexcept {
+        return Apply<simd::BitOp::kAndNot>(other);
+    }
+
+    BitVector& Not() noexcept {
+        simd::NotWords(words_.begin(), words_.GetSize());
+        ClearTail();
+        return *this;
+    }
+
+    // Количество установленных битов
+    size_t Count() const noexcept {
+        return simd::PopCount(words_.begin(), words_.GetSize());
+    }
+
+    bool Any() const noexcept {
+        return FindFirst() != size_;
+    }
+
+    bool None() const noexcept {
+        return !Any();
+    }
+
+    bool All() const noexcept {
+        return Count() == size_;
+    }
+
+    // Индекс первого установленного бита или GetSize()
+    size_t FindFirst() const noexcept {
+        return FindFromWord(0);
+    }
+
+    // Индекс первого установленного бита после pos или GetSize()
+    size_t FindNext(size_t pos) const noexcept {
+        if (pos + 1 >= size_) {
+            return size_;
+        }
+        ++pos;
+        const size_t word_index = pos / kWordBits;
+        const Word word = words_[word_index] & (~Word(0) << (pos % kWordBits));
+        if (word != 0) {
+            return word_index * kWordBits + __builtin_ctzll(word);
+        }
+        return FindFromWord(word_index + 1);
+    }
+
+    // Слова с битами: бит i - это (Words()[i / 64] >> (i % 64)) & 1
+    const Word* Words() const noexcept {
+        return words_.begin();
+    }
+
+    size_t GetWordCount() const noexcept {
+        return words_.GetSize();
+    }
+
+    friend bool operator==(const BitVector& lhs, const BitVector& rhs) noexcept {
+        return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+    }
+
+    friend bool operator!=(const BitVector& lhs, const BitVector& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    static size_t WordCount(size_t bits) noexcept {
+        return (bits + kWordBits - 1) / kWordBits;
+    }
+
+    static Word Mask(size_t index) noexcept {
+        return Word(1) << (index % kWordBits);
+    }
+
+    // Обнуляет биты последнего слова за пределами размера
+    void ClearTail() noexcept {
+        if (size_ % kWordBits != 0) {
+            words_[words_.GetSize() - 1] &= ~(~Word(0) << (size_ % kWordBits));
+        }
+    }
+
+    template <simd::BitOp kOp>
+    BitVector& Apply(const BitVector& other) noexcept {
+        assert(size_ == other.size_);
+        simd::ApplyBitOp<kOp>(words_.begin(), other.words_.begin(), words_.GetSize());
+        return *this;
+    }
+
+    size_t FindFromWord(size_t word_index) const noexcept {
+        for (; word_index < words_.GetSize(); ++word_index) {
+            if (words_[word_index] != 0) {
+                return word_index * kWordBits + __builtin_ctzll(words_[word_index]);
+            }
+        }
+        return size_;
+    }
+
+    SimpleVector<Word> words_;
+    size_t size_ = 0;
+};
+
+// Вспомогательная структура для Rank и Select над неизменным BitVector.
+// Хранит число единиц перед каждым блоком из 8 слов (512 битов): 1/8 бита
+// на бит данных. Rank считает не больше 8 слов, Select ищет блок двоичным поиском.
+// Слова считаются через simd::PopCount, которому доступна инструкция popcnt.
+// После изменения вектора структуру нужно построить заново
+class RankSelect {
+public:
+    explicit RankSelect(const BitVector& bits)
+        : bits_(&bits)
+        , block_ranks_(Reserve(bits.GetWordCount() / kBlockWords + 2)) {
+        const BitVector::Word* words = bits.Words();
+        const size_t word_count = bits.GetWordCount();
+        size_t ones = 0;
+        block_ranks_.PushBack(0);
+        for (size_t first = 0; first < word_count; first += kBlockWords) {
+            ones += simd::PopCount(words + first, std::min(kBlockWords, word_count - first));
+            block_ranks_.PushBack(ones);
+        }
+    }
+
+    // Количество установленных битов в [0, pos), pos <= size
+    size_t Rank(size_t pos) const noexcept {
+        assert(pos <= bits_->GetSize());
+        const BitVector::Word* words = bits_->Words();
+        const size_t word_index = pos / BitVector::kWordBits;
+        const size_t block = word_index / kBlockWords;
+        size_t rank = block_ranks_[block] + simd::PopCount(words + block * kBlockWords, word_index - block * kBlockWords);
+        if (const size_t offset = pos % BitVector::kWordBits; offset != 0) {
+            const BitVector::Word head = words[word_index] & ~(~BitVector::Word(0) << offset);
+            rank += simd::PopCount(&head, 1);
+        }
+        return rank;
+    }
+
+    // Позиция установленного бита с номером k (с нуля) или size, если единиц не больше k
+    size_t Select(size_t k) const noexcept {
+        if (k >= GetOnes()) {
+            return bits_->GetSize();
+        }
+        // Последний блок, перед которым не больше k единиц
+        const size_t block = std::upper_bound(block_ranks_.begin(), block_ranks_.end(), k) - block_ranks_.begin() - 1;
+        k -= block_ranks_[block];
+        const BitVector::Word* words = bits_->Words();
+        size_t word_index = block * kBlockWords;
+        for (;; ++word_index) {
+            const size_t ones = simd::PopCount(words + word_index, 1);
+            if (k < ones) {
+                break;
+            }
+            k -= ones;
+        }
+        BitVector::Word word = words[word_index];
+        for (; k > 0; --k) {
+            word &= word - 1;
+        }
+        return word_index * BitVector::kWordBits + __builtin_ctzll(word);
+    }
+
+    // Всего установленных битов
+    size_t GetOnes() const noexcept {
+        return block_ranks_[block_ranks_.GetSize() - 1];
+    }
+
+private:
+    static constexpr size_t kBlockWords = 8;
+
+    const BitVector* bits_;
+    SimpleVector<size_t> block_ranks_;
+};
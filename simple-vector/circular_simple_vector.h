@@ -0,0 +1,632 @@
+#pragma once
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "simple_vector.h"
+
+// Политика для CircularSimpleVector: кольцо фиксированной вместимости, в котором
+// новый элемент вытесняет самый старый вместо увеличения буфера.
+// Вместимость задаётся конструктором с Reserve(n) или методом Reserve; добавление
+// в кольцо нулевой вместимости выбрасывает исключение std::length_error
+struct OverwriteOldest {
+};
+
+// Двусторонняя очередь в одном непрерывном кольцевом буфере.
+// Логический элемент i лежит в ячейке (head_ + i) mod capacity, поэтому добавление
+// и удаление с обоих концов стоят O(1), а вставка и удаление в середине сдвигают
+// только меньшую из двух частей. При нехватке места вместимость растёт по GrowthPolicy,
+// как у SimpleVector, и элементы переносятся в начало нового буфера.
+// С политикой OverwriteOldest вместимость не растёт сама: PushBack в заполненное кольцо
+// удаляет первый элемент, PushFront - последний.
+// Аллокаторы разных векторов при обмене и перемещающем присваивании должны быть равны,
+// если propagate_on_container_swap не разрешает их обменивать
+template <typename Type, typename Alloc = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class CircularSimpleVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Storage = ArrayPtr<Type, Alloc>;
+
+    static constexpr bool kOverwrite = std::is_same_v<GrowthPolicy, OverwriteOldest>;
+
+public:
+    using allocator_type = Alloc;
+
+    // Итератор произвольного доступа: хранит вектор и логический индекс,
+    // поэтому остаётся верным при сдвиге head_, но не при перераспределении памяти
+    template <bool kConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<kConst, const CircularSimpleVector, CircularSimpleVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<kConst, const Type*, Type*>;
+        using reference = std::conditional_t<kConst, const Type&, Type&>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        BasicIterator(const BasicIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*owner_)[index_];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*owner_)[index_ + n];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator+(difference_type n, BasicIterator it) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class CircularSimpleVector;
+        friend class BasicIterator<!kConst>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    CircularSimpleVector() noexcept(noexcept(Alloc())) = default;
+
+    explicit CircularSimpleVector(const Alloc& alloc) noexcept
+        : storage_(alloc) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit CircularSimpleVector(size_t size, const Alloc& alloc = Alloc())
+        : CircularSimpleVector(ReserveProxyObj(size), alloc) {
+        while (size_ < size) {
+            EmplaceBack();
+        }
+    }
+
+    CircularSimpleVector(size_t size, const Type& value, const Alloc& alloc = Alloc())
+        : CircularSimpleVector(ReserveProxyObj(size), alloc) {
+        while (size_ < size) {
+            EmplaceBack(value);
+        }
+    }
+
+    CircularSimpleVector(std::initializer_list<Type> init, const Alloc& alloc = Alloc())
+        : CircularSimpleVector(ReserveProxyObj(init.size()), alloc) {
+        for (const Type& item : init) {
+            EmplaceBack(item);
+        }
+    }
+
+    // Элементы остальных конструкторов создаются уже после этого, делегируемого,
+    // поэтому при исключении деструктор разрушит созданные
+    CircularSimpleVector(ReserveProxyObj Rpo, const Alloc& alloc = Alloc())
+        : storage_(Rpo.GetRes(), alloc) {
+    }
+
+    CircularSimpleVector(const CircularSimpleVector& other)
+        : CircularSimpleVector(ReserveProxyObj(other.GetCapacity()),
+                               AllocTraits::select_on_container_copy_construction(other.get_allocator())) {
+        for (const Type& item : other) {
+            EmplaceBack(item);
+        }
+    }
+
+    CircularSimpleVector(CircularSimpleVector&& other) noexcept
+        : storage_(std::move(other.storage_))
+        , head_(std::exchange(other.head_, 0))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    CircularSimpleVector& operator=(const CircularSimpleVector& rhs) {
+        if (this != &rhs) {
+            CircularSimpleVector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    CircularSimpleVector& operator=(CircularSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            CircularSimpleVector tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~CircularSimpleVector() {
+        Clear();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return storage_.GetAllocator();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return storage_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    bool IsFull() const noexcept {
+        return size_ == GetCapacity();
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return storage_[Slot(index)];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return storage_[Slot(index)];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return (*this)[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return (*this)[index];
+    }
+
+    Type& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const Type& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    Type& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const Type& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    Iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    Iterator end() noexcept {
+        return {this, size_};
+    }
+
+    ConstIterator begin() const noexcept {
+        return cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return cend();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return {this, 0};
+    }
+
+    ConstIterator cend() const noexcept {
+        return {this, size_};
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    void PushFront(const Type& item) {
+        EmplaceFront(item);
+    }
+
+    void PushFront(Type&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    // Создаёт элемент из args после последнего и возвращает ссылку на него.
+    // Даёт строгую гарантию безопасности исключений, если Type копируем
+    // или его перемещающий конструктор не бросает исключений.
+    // С OverwriteOldest в заполненном кольце строгая гарантия есть, только если перемещающий
+    // конструктор не бросает исключений: иначе вытесненный элемент может пропасть
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (!IsFull()) {
+            Construct(&storage_[Slot(size_)], std::forward<Args>(args)...);
+            ++size_;
+        } else if constexpr (kOverwrite) {
+            CheckRingCapacity();
+            Type item(std::forward<Args>(args)...);
+            PopFront();
+            Construct(&storage_[Slot(size_)], std::move(item));
+            ++size_;
+        } else {
+            ReallocateWithGap(GrownCapacity(size_ + 1), size_, [&](Type* gap) {
+                Construct(gap, std::forward<Args>(args)...);
+            });
+        }
+        return Back();
+    }
+
+    // Создаёт элемент из args перед первым и возвращает ссылку на него.
+    // Гарантии те же, что у EmplaceBack
+    template <typename... Args>
+    Type& EmplaceFront(Args&&... args) {
+        if (!IsFull()) {
+            const size_t slot = head_ == 0 ? GetCapacity() - 1 : head_ - 1;
+            Construct(&storage_[slot], std::forward<Args>(args)...);
+            head_ = slot;
+            ++size_;
+        } else if constexpr (kOverwrite) {
+            CheckRingCapacity();
+            Type item(std::forward<Args>(args)...);
+            PopBack();
+            const size_t slot = head_ == 0 ? GetCapacity() - 1 : head_ - 1;
+            Construct(&storage_[slot], std::move(item));
+            head_ = slot;
+            ++size_;
+        } else {
+            ReallocateWithGap(GrownCapacity(size_ + 1), 0, [&](Type* gap) {
+                Construct(gap, std::forward<Args>(args)...);
+            });
+        }
+        return Front();
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        Destroy(&Back());
+        --size_;
+    }
+
+    void PopFront() noexcept {
+        assert(!IsEmpty());
+        Destroy(&Front());
+        head_ = Slot(1);
+        --size_;
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из args в позиции pos и возвращает итератор на него.
+    // Сдвигается меньшая из частей до и после pos. В заполненном кольце
+    // с OverwriteOldest сначала удаляется первый элемент
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos.index_ <= size_);
+        size_t index = pos.index_;
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return {this, size_ - 1};
+        }
+        if (index == 0) {
+            EmplaceFront(std::forward<Args>(args)...);
+            return begin();
+        }
+        if (IsFull() && !kOverwrite) {
+            ReallocateWithGap(GrownCapacity(size_ + 1), index, [&](Type* gap) {
+                Construct(gap, std::forward<Args>(args)...);
+            });
+            return {this, index};
+        }
+        // Временный объект нужен и на случай, если args ссылаются на сдвигаемые элементы
+        Type item(std::forward<Args>(args)...);
+        if (IsFull()) {
+            PopFront();
+            if (--index == 0) {
+                EmplaceFront(std::move(item));
+                return begin();
+            }
+        }
+        if (index < size_ - index) {
+            EmplaceFront(std::move(Front()));
+            for (size_t i = 1; i < index; ++i) {
+                (*this)[i] = std::move((*this)[i + 1]);
+            }
+        } else {
+            EmplaceBack(std::move(Back()));
+            for (size_t i = size_ - 2; i > index; --i) {
+                (*this)[i] = std::move((*this)[i - 1]);
+            }
+        }
+        (*this)[index] = std::move(item);
+        return {this, index};
+    }
+
+    // Удаляет элемент в позиции pos, сдвигая меньшую из частей.
+    // Возвращает итератор на следующий за удалённым элемент
+    Iterator Erase(ConstIterator pos) {
+        assert(pos.index_ < size_);
+        const size_t index = pos.index_;
+        if (index < size_ - index - 1) {
+            for (size_t i = index; i > 0; --i) {
+                (*this)[i] = std::move((*this)[i - 1]);
+            }
+            PopFront();
+        } else {
+            for (size_t i = index; i + 1 < size_; ++i) {
+                (*this)[i] = std::move((*this)[i + 1]);
+            }
+            PopBack();
+        }
+        return {this, index};
+    }
+
+    void Clear() noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            Destroy(&(*this)[i]);
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Увеличивает вместимость до new_capacity; элементы переносятся в начало нового буфера
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            ReallocateWithGap(new_capacity, size_, nullptr);
+        }
+    }
+
+    // Изменяет размер: лишние элементы удаляются с конца,
+    // новые добавляются в конец со значением по умолчанию
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        if (new_size > GetCapacity()) {
+            Reserve(kOverwrite ? new_size : GrownCapacity(new_size));
+        }
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    void swap(CircularSimpleVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            storage_.SwapWithAllocator(other.storage_);
+        } else {
+            storage_.swap(other.storage_);
+        }
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    // Кольцо OverwriteOldest не растёт само, поэтому без вместимости в него нечего записать
+    void CheckRingCapacity() const {
+        if (GetCapacity() == 0) {
+            throw std::length_error("RingWindow has no capacity; call Reserve first");
+        }
+    }
+
+    // Ячейка буфера с логическим индексом index <= capacity
+    size_t Slot(size_t index) const noexcept {
+        const size_t slot = head_ + index;
+        return slot >= GetCapacity() ? slot - GetCapacity() : slot;
+    }
+
+    size_t GrownCapacity(size_t required) const noexcept {
+        if constexpr (kOverwrite) {
+            return required;
+        } else {
+            return std::max(GrowthPolicy::Next(GetCapacity(), sizeof(Type)), required);
+        }
+    }
+
+    template <typename... Args>
+    void Construct(Type* place, Args&&... args) {
+        AllocTraits::construct(storage_.GetAllocator(), place, std::forward<Args>(args)...);
+    }
+
+    void Destroy(Type* place) noexcept {
+        AllocTraits::destroy(storage_.GetAllocator(), place);
+    }
+
+    // Переносит count элементов от from в to, как SimpleVector: memcpy для тривиально
+    // переносимых типов, иначе std::move_if_noexcept. При исключении созданное разрушается
+    void RelocateN(Type* from, size_t count, Type* to) {
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+            }
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < count; ++done) {
+                    Construct(to + done, std::move_if_noexcept(from[done]));
+                }
+            } catch (...) {
+                for (size_t i = 0; i < done; ++i) {
+                    Destroy(to + i);
+                }
+                throw;
+            }
+        }
+    }
+
+    // Переносит логические элементы [first, first + count) в to: кольцевой диапазон
+    // состоит не более чем из двух непрерывных кусков
+    void RelocateRange(size_t first, size_t count, Type* to) {
+        const size_t slot = Slot(first);
+        const size_t first_part = std::min(count, GetCapacity() - slot);
+        RelocateN(storage_.Get() + slot, first_part, to);
+        try {
+            RelocateN(storage_.Get(), count - first_part, to + first_part);
+        } catch (...) {
+            for (size_t i = 0; i < first_part; ++i) {
+                Destroy(to + i);
+            }
+            throw;
+        }
+    }
+
+    // Переносит элементы в новый буфер вместимостью new_capacity, оставляя перед элементом
+    // с индексом index ячейку, которую заполняет construct_gap(Type* gap). Если construct_gap
+    // равен nullptr, промежутка нет и размер не меняется
+    template <typename ConstructGap>
+    void ReallocateWithGap(size_t new_capacity, size_t index, ConstructGap&& construct_gap) {
+        constexpr bool kHasGap = !std::is_null_pointer_v<std::decay_t<ConstructGap>>;
+        Storage tmp(new_capacity, storage_.GetAllocator());
+        if constexpr (kHasGap) {
+            construct_gap(tmp.Get() + index);
+        }
+        try {
+            RelocateRange(0, index, tmp.Get());
+        } catch (...) {
+            if constexpr (kHasGap) {
+                Destroy(tmp.Get() + index);
+            }
+            throw;
+        }
+        try {
+            RelocateRange(index, size_ - index, tmp.Get() + index + kHasGap);
+        } catch (...) {
+            for (size_t i = 0; i < index + kHasGap; ++i) {
+                Destroy(tmp.Get() + i);
+            }
+            throw;
+        }
+        if constexpr (!IsTriviallyRelocatableV<Type>) {
+            for (size_t i = 0; i < size_; ++i) {
+                Destroy(&(*this)[i]);
+            }
+        }
+        storage_.swap(tmp);
+        head_ = 0;
+        size_ += kHasGap;
+    }
+
+    Storage storage_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// Окно последних элементов фиксированной вместимости
+template <typename Type, typename Alloc = std::allocator<Type>>
+using RingWindow = CircularSimpleVector<Type, Alloc, OverwriteOldest>;
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+bool operator==(const CircularSimpleVector<Type, Alloc, GrowthPolicy>& lhs,
+                const CircularSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+bool operator!=(const CircularSimpleVector<Type, Alloc, GrowthPolicy>& lhs,
+                const CircularSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+bool operator<(const CircularSimpleVector<Type, Alloc, GrowthPolicy>& lhs,
+               const CircularSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
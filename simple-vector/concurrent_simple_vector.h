@@ -0,0 +1,278 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "simple_vector.h"
+
+// Вектор для одновременного добавления элементов из многих потоков.
+// Элементы хранятся в сегментах ArrayPtr, каждый следующий вдвое больше предыдущего,
+// поэтому при росте элементы никогда не перемещаются и ссылки на них остаются действительными.
+// PushBack и EmplaceBack lock-free: сегмент под следующий индекс публикуется через
+// compare_exchange, а затем индекс резервируется compare_exchange счётчика размера.
+// Память выделяется до резервирования, поэтому исключение не оставляет пропусков.
+// Для типов с бросающим перемещением добавления идут по одному под спин-блокировкой:
+// размер увеличивается только после того, как элемент создан.
+//
+// Читать элемент можно одновременно с добавлением других, если поток-читатель узнал
+// его индекс после возврата из PushBack (через любую синхронизацию с добавившим потоком).
+// Freeze, Clear, Reserve, деструктор и перемещение требуют, чтобы вектор не использовался
+// другими потоками. Аллокатор вызывается из разных потоков и должен быть потокобезопасным
+template <typename Type, typename Alloc = std::allocator<Type>>
+class ConcurrentSimpleVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Storage = ArrayPtr<Type, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+
+    // Размер первого сегмента; степень двойки
+    static constexpr size_t kFirstSegmentSize = 64;
+
+    ConcurrentSimpleVector() noexcept(noexcept(Alloc())) = default;
+
+    explicit ConcurrentSimpleVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+    ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+    ConcurrentSimpleVector(ConcurrentSimpleVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , size_(other.size_.exchange(0, std::memory_order_relaxed)) {
+        for (size_t k = 0; k < kMaxSegments; ++k) {
+            segments_[k].store(other.segments_[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    ~ConcurrentSimpleVector() {
+        Clear();
+        for (size_t k = 0; k < kMaxSegments; ++k) {
+            Storage segment(segments_[k].load(std::memory_order_relaxed), SegmentSize(k), alloc_);
+        }
+    }
+
+    Alloc get_allocator() const noexcept {
+        return alloc_;
+    }
+
+    // Число зарезервированных индексов. Пока идут добавления, часть элементов
+    // с меньшими индексами может быть ещё не создана
+    size_t GetSize() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Количество элементов, под которые уже выделены сегменты
+    size_t GetCapacity() const noexcept {
+        size_t capacity = 0;
+        for (size_t k = 0; k < kMaxSegments && segments_[k].load(std::memory_order_acquire) != nullptr; ++k) {
+            capacity += SegmentSize(k);
+        }
+        return capacity;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        const auto [segment, offset] = Locate(index);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        const auto [segment, offset] = Locate(index);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Invalid index");
+        }
+        return (*this)[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Invalid index");
+        }
+        return (*this)[index];
+    }
+
+    // Добавляет элемент и возвращает его индекс, который не изменится до Clear или Freeze
+    size_t PushBack(const Type& item) {
+        return EmplaceBack(item);
+    }
+
+    size_t PushBack(Type&& item) {
+        return EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент из args и возвращает его индекс.
+    // Индекс резервируется, только когда элемент уже точно будет создан: если конструктор
+    // может бросить исключение, элемент сначала создаётся во временном объекте и затем
+    // перемещается. При исключении размер вектора не меняется
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        if constexpr (!std::is_nothrow_move_constructible_v<Type>) {
+            return EmplaceBackLocked(std::forward<Args>(args)...);
+        } else if constexpr (std::is_nothrow_constructible_v<Type, Args&&...>) {
+            const Slot slot = ClaimSlot();
+            AllocTraits::construct(alloc_, slot.place, std::forward<Args>(args)...);
+            return slot.index;
+        } else {
+            Type item(std::forward<Args>(args)...);
+            const Slot slot = ClaimSlot();
+            AllocTraits::construct(alloc_, slot.place, std::move(item));
+            return slot.index;
+        }
+    }
+
+    // Заранее выделяет сегменты под capacity элементов
+    void Reserve(size_t capacity) {
+        for (size_t k = 0; k < kMaxSegments && SegmentBase(k) < capacity; ++k) {
+            AcquireSegment(k);
+        }
+    }
+
+    // Разрушает все элементы. Выделенные сегменты остаются для повторного использования
+    void Clear() noexcept {
+        const size_t size = size_.exchange(0, std::memory_order_relaxed);
+        for (size_t k = 0; k < kMaxSegments && SegmentBase(k) < size; ++k) {
+            Type* data = segments_[k].load(std::memory_order_relaxed);
+            const size_t count = std::min(SegmentSize(k), size - SegmentBase(k));
+            for (size_t i = 0; i < count; ++i) {
+                AllocTraits::destroy(alloc_, data + i);
+            }
+        }
+    }
+
+    // Переносит элементы в непрерывный SimpleVector с тем же аллокатором
+    // и оставляет этот вектор пустым. Память выделяется один раз;
+    // тривиально переносимые типы копируются по сегменту за раз
+    template <typename GrowthPolicy = DoublingGrowth, typename StatsPolicy = NoStats>
+    SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy> Freeze() {
+        const size_t size = GetSize();
+        SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy> result(ReserveProxyObj(size), alloc_);
+        result.AppendWith(size, [&](Type* dest, size_t count) {
+            size_t done = 0;
+            try {
+                for (size_t k = 0; done < count; ++k) {
+                    Type* data = segments_[k].load(std::memory_order_relaxed);
+                    const size_t chunk = std::min(SegmentSize(k), count - done);
+                    if constexpr (IsTriviallyRelocatableV<Type>) {
+                        std::memcpy(static_cast<void*>(dest + done), static_cast<const void*>(data), chunk * sizeof(Type));
+                    } else {
+                        std::uninitialized_move_n(data, chunk, dest + done);
+                    }
+                    done += chunk;
+                }
+            } catch (...) {
+                std::destroy_n(dest, done);
+                throw;
+            }
+        });
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            // Байты уже перенесены, разрушать исходные объекты не нужно
+            size_.store(0, std::memory_order_relaxed);
+        } else {
+            Clear();
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t kFirstSegmentShift = 6;
+    static_assert(kFirstSegmentSize == size_t(1) << kFirstSegmentShift);
+    // Сегменты покрывают все индексы, представимые в size_t
+    static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - kFirstSegmentShift;
+
+    struct Position {
+        size_t segment;
+        size_t offset;
+    };
+
+    struct Slot {
+        size_t index;
+        Type* place;
+    };
+
+    // Сегмент k вмещает kFirstSegmentSize << k элементов и начинается с индекса
+    // (kFirstSegmentSize << k) - kFirstSegmentSize
+    static size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    static size_t SegmentBase(size_t segment) noexcept {
+        return SegmentSize(segment) - kFirstSegmentSize;
+    }
+
+    static Position Locate(size_t index) noexcept {
+        const size_t shifted = index + kFirstSegmentSize;
+        const size_t top_bit = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(shifted);
+        const size_t segment = top_bit - kFirstSegmentShift;
+        return {segment, shifted - SegmentSize(segment)};
+    }
+
+    // Возвращает сегмент, выделяя его при необходимости. Если несколько потоков
+    // выделили сегмент одновременно, публикуется один, а остальные освобождают свою память
+    Type* AcquireSegment(size_t segment) {
+        Type* data = segments_[segment].load(std::memory_order_acquire);
+        if (data != nullptr) {
+            return data;
+        }
+        Storage fresh(SegmentSize(segment), alloc_);
+        if (segments_[segment].compare_exchange_strong(data, fresh.Get(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return fresh.Release();
+        }
+        return data;
+    }
+
+    // Резервирует следующий индекс. Сегмент под него выделяется до резервирования,
+    // поэтому bad_alloc вылетает, не оставив под size_ незанятой ячейки
+    Slot ClaimSlot() {
+        size_t index = size_.load(std::memory_order_relaxed);
+        for (;;) {
+            const auto [segment, offset] = Locate(index);
+            Type* data = AcquireSegment(segment);
+            if (size_.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return {index, data + offset};
+            }
+        }
+    }
+
+    // Добавление для типов с бросающим перемещением: элемент создаётся прямо на месте
+    // следующего индекса, поэтому добавляющие потоки проходят по одному
+    template <typename... Args>
+    size_t EmplaceBackLocked(Args&&... args) {
+        while (adding_.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        struct Unlock {
+            std::atomic<bool>& adding;
+            ~Unlock() {
+                adding.store(false, std::memory_order_release);
+            }
+        } unlock{adding_};
+        const size_t index = size_.load(std::memory_order_relaxed);
+        const auto [segment, offset] = Locate(index);
+        Type* data = AcquireSegment(segment);
+        AllocTraits::construct(alloc_, data + offset, std::forward<Args>(args)...);
+        size_.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+    Alloc alloc_;
+    std::atomic<size_t> size_{0};
+    std::atomic<bool> adding_{false};
+    std::atomic<Type*> segments_[kMaxSegments] = {};
+};
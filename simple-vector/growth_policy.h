@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+
+// Политики роста вместимости SimpleVector.
+// Политика - это тип со статическим методом
+//     static size_t Next(size_t capacity, size_t element_size) noexcept,
+// возвращающим вместимость после очередного увеличения вектора вместимостью capacity.
+// Результат должен быть больше capacity; если его не хватает для вставки,
+// вектор сам увеличит его до необходимого размера.
+// Геометрический рост (множитель больше 1) даёт амортизированное O(1) на вставку
+
+namespace growth_detail {
+
+// capacity * num / den с насыщением вместо переполнения
+inline size_t ScaleSaturated(size_t capacity, size_t num, size_t den) noexcept {
+    constexpr size_t kMax = std::numeric_limits<size_t>::max();
+    if (capacity > kMax / num) {
+        return kMax;
+    }
+    return std::max(capacity * num / den, capacity + 1);
+}
+
+}  // namespace growth_detail
+
+// Увеличивает вместимость вдвое, для пустого вектора - до 1
+struct DoublingGrowth {
+    static size_t Next(size_t capacity, size_t) noexcept {
+        return capacity == 0 ? 1 : growth_detail::ScaleSaturated(capacity, 2, 1);
+    }
+};
+
+// Увеличивает вместимость в 1.5 раза: освобождённые блоки раньше
+// становятся пригодными для повторного использования аллокатором
+struct OneAndHalfGrowth {
+    static size_t Next(size_t capacity, size_t) noexcept {
+        return capacity == 0 ? 1 : growth_detail::ScaleSaturated(capacity, 3, 2);
+    }
+};
+
+// Увеличивает вместимость примерно в 1.618 раза (золотое сечение)
+struct GoldenRatioGrowth {
+    static size_t Next(size_t capacity, size_t) noexcept {
+        return capacity == 0 ? 1 : growth_detail::ScaleSaturated(capacity, 1618, 1000);
+    }
+};
+
+// Растёт как Inner, но округляет размер буфера в байтах вверх до целого числа страниц,
+// чтобы хвост последней страницы не пропадал впустую
+template <typename Inner = DoublingGrowth, size_t kPageSize = 4096>
+struct PageRoundedGrowth {
+    static size_t Next(size_t capacity, size_t element_size) noexcept {
+        const size_t next = Inner::Next(capacity, element_size);
+        if (next > (std::numeric_limits<size_t>::max() - kPageSize) / element_size) {
+            return next;
+        }
+        const size_t bytes = (next * element_size + kPageSize - 1) / kPageSize * kPageSize;
+        return bytes / element_size;
+    }
+};
+
+// Растёт как Inner, пока шаг роста не превышает kMaxStepBytes, а дальше
+// добавляет по kMaxStepBytes. Для огромных буферов ограничивает перерасход памяти
+// ценой линейного роста: после порога вставка стоит O(size / шаг) амортизированно
+template <size_t kMaxStepBytes = (size_t(64) << 20), typename Inner = DoublingGrowth>
+struct CappedLinearGrowth {
+    static size_t Next(size_t capacity, size_t element_size) noexcept {
+        const size_t next = Inner::Next(capacity, element_size);
+        const size_t max_step = std::max<size_t>(kMaxStepBytes / element_size, 1);
+        if (next - capacity <= max_step) {
+            return next;
+        }
+        return capacity + max_step;
+    }
+};
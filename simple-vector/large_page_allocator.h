@@ -0,0 +1,176 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Размещение больших массивов: выравнивание под SIMD и кеш-линии, крупные страницы
+// и распределение страниц по узлам NUMA.
+// Политика NUMA задаётся до первого обращения к памяти, поэтому страницы попадают
+// на нужные узлы, когда их впервые заполняют элементы. При NumaPolicy::kDefault
+// страница достаётся узлу потока, который первым её коснулся: чтобы распределить
+// страницы между узлами потоков, вектор заполняют параллельно (ParallelMakeVector)
+
+enum class NumaPolicy {
+    kDefault,     // политика процесса, обычно «узел первого обращения»
+    kBind,        // страницы только на узлах из node_mask
+    kInterleave,  // страницы по очереди на узлах из node_mask
+};
+
+struct LargePageOptions {
+    // Выравнивание начала буфера в байтах, степень двойки
+    size_t alignment = 64;
+    // Выравнивать буфер по 2 МБ и просить ядро отдать его прозрачными крупными страницами
+    // (MADV_HUGEPAGE). Это лишь подсказка: без поддержки THP буфер выделяется обычными страницами
+    bool huge_pages = false;
+    NumaPolicy numa = NumaPolicy::kDefault;
+    // Битовая маска узлов для kBind и kInterleave
+    unsigned long node_mask = 1;
+
+    friend bool operator==(const LargePageOptions& lhs, const LargePageOptions& rhs) noexcept {
+        return lhs.alignment == rhs.alignment && lhs.huge_pages == rhs.huge_pages && lhs.numa == rhs.numa
+               && lhs.node_mask == rhs.node_mask;
+    }
+
+    friend bool operator!=(const LargePageOptions& lhs, const LargePageOptions& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+};
+
+namespace large_page_detail {
+
+inline constexpr size_t kHugePageSize = size_t(2) << 20;
+
+// Константы mempolicy из <linux/mempolicy.h>. mbind вызывается напрямую через syscall,
+// чтобы не зависеть от libnuma
+inline constexpr int kMpolBind = 2;
+inline constexpr int kMpolInterleave = 3;
+
+inline size_t RoundUp(size_t value, size_t step) noexcept {
+    return (value + step - 1) / step * step;
+}
+
+inline size_t PageSize() noexcept {
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+// Память выделяется через mmap, если нужны крупные страницы или политика NUMA:
+// обе настройки применяются к целым страницам
+inline bool UsesMmap(const LargePageOptions& options) noexcept {
+    return options.huge_pages || options.numa != NumaPolicy::kDefault;
+}
+
+// Размер отображения для bytes байт
+inline size_t MappedBytes(size_t bytes, const LargePageOptions& options) noexcept {
+    return RoundUp(bytes, options.huge_pages ? kHugePageSize : PageSize());
+}
+
+inline void* MapPages(size_t bytes, const LargePageOptions& options) {
+    const size_t length = MappedBytes(bytes, options);
+    const size_t alignment = std::max({options.alignment, options.huge_pages ? kHugePageSize : size_t(0), PageSize()});
+    // Запас на выравнивание, лишнее по краям потом отрезается
+    const size_t reserved = length + alignment - PageSize();
+    void* base = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    const auto begin = reinterpret_cast<std::uintptr_t>(base);
+    const std::uintptr_t aligned = RoundUp(begin, alignment);
+    if (aligned != begin) {
+        ::munmap(base, aligned - begin);
+    }
+    if (const size_t tail = begin + reserved - (aligned + length); tail != 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    void* result = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (options.huge_pages) {
+        // Ошибка означает, что THP выключены, и память остаётся на обычных страницах
+        ::madvise(result, length, MADV_HUGEPAGE);
+    }
+#endif
+    if (options.numa != NumaPolicy::kDefault) {
+        const int mode = options.numa == NumaPolicy::kBind ? kMpolBind : kMpolInterleave;
+        const unsigned long mask = options.node_mask;
+        if (::syscall(SYS_mbind, result, length, mode, &mask, sizeof(mask) * 8, 0) != 0) {
+            const int error = errno;
+            ::munmap(result, length);
+            throw std::system_error(error, std::generic_category(), "mbind");
+        }
+    }
+    return result;
+}
+
+}  // namespace large_page_detail
+
+// Аллокатор для больших векторов с настройками LargePageOptions.
+// Без крупных страниц и NUMA память берётся у выровненного operator new,
+// иначе отображается напрямую через mmap с нужным выравниванием.
+// Аллокаторы с одинаковыми настройками взаимозаменяемы
+template <typename T>
+class LargePageAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    LargePageAllocator() noexcept = default;
+
+    explicit LargePageAllocator(const LargePageOptions& options) noexcept
+        : options_(options) {
+    }
+
+    template <typename U>
+    LargePageAllocator(const LargePageAllocator<U>& other) noexcept
+        : options_(other.GetOptions()) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (large_page_detail::UsesMmap(options_)) {
+            return static_cast<T*>(large_page_detail::MapPages(bytes, options_));
+        }
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(Alignment())));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (large_page_detail::UsesMmap(options_)) {
+            ::munmap(p, large_page_detail::MappedBytes(bytes, options_));
+        } else {
+            ::operator delete(p, bytes, std::align_val_t(Alignment()));
+        }
+    }
+
+    const LargePageOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    template <typename U>
+    friend bool operator==(const LargePageAllocator& lhs, const LargePageAllocator<U>& rhs) noexcept {
+        return lhs.GetOptions() == rhs.GetOptions();
+    }
+
+    template <typename U>
+    friend bool operator!=(const LargePageAllocator& lhs, const LargePageAllocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    size_t Alignment() const noexcept {
+        return std::max(options_.alignment, alignof(T));
+    }
+
+    LargePageOptions options_;
+};
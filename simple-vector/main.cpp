@@ -1,9 +1,38 @@
 #include "simple_vector.h"
+#include "simple_vector_view.h"
+#include "bit_vector.h"
+#include "circular_simple_vector.h"
+#include "concurrent_simple_vector.h"
+#include "large_page_allocator.h"
+#include "mapped_simple_vector.h"
+#include "packed_int_vector.h"
+#include "parallel.h"
+#include "persistent_simple_vector.h"
+#include "recycling_allocator.h"
+#include "serialization.h"
+#include "small_simple_vector.h"
+#include "soa_simple_vector.h"
+#include "vector_expr.h"
 
+#include <atomic>
+#include <bitset>
 #include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -32,63 +61,150 @@ private:
     size_t x_;
 };
 
-SimpleVector<int> GenerateVector(size_t size) {
-    SimpleVector<int> v(size);
+// Считает живые экземпляры, чтобы проверить, что вместимость не создаёт объектов
+class Counted {
+public:
+    explicit Counted(int value)
+        : value_(value) {
+        ++alive;
+    }
+    Counted(const Counted& other)
+        : value_(other.value_) {
+        ++alive;
+    }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() {
+        --alive;
+    }
+    int GetValue() const {
+        return value_;
+    }
+
+    static inline int alive = 0;
+
+private:
+    int value_;
+};
+
+struct AllocationStats {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytes_in_use = 0;
+};
+
+inline AllocationStats default_allocation_stats;
+
+// Stateful-аллокатор, считающий выделения в привязанном к нему AllocationStats.
+// Аллокаторы равны, если ведут один и тот же счёт
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = true_type;
+    using propagate_on_container_move_assignment = true_type;
+    using propagate_on_container_swap = true_type;
+
+    CountingAllocator() noexcept
+        : stats_(&default_allocation_stats) {
+    }
+    explicit CountingAllocator(AllocationStats* stats) noexcept
+        : stats_(stats) {
+    }
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept
+        : stats_(other.GetStats()) {
+    }
+
+    T* allocate(size_t n) {
+        T* result = allocator<T>().allocate(n);
+        ++stats_->allocations;
+        stats_->bytes_in_use += n * sizeof(T);
+        return result;
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        ++stats_->deallocations;
+        stats_->bytes_in_use -= n * sizeof(T);
+        allocator<T>().deallocate(p, n);
+    }
+
+    AllocationStats* GetStats() const noexcept {
+        return stats_;
+    }
+
+    friend bool operator==(const CountingAllocator& lhs, const CountingAllocator& rhs) noexcept {
+        return lhs.stats_ == rhs.stats_;
+    }
+    friend bool operator!=(const CountingAllocator& lhs, const CountingAllocator& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    AllocationStats* stats_;
+};
+
+template <template <typename> class Alloc>
+SimpleVector<int, Alloc<int>> GenerateVector(size_t size) {
+    SimpleVector<int, Alloc<int>> v(size);
     iota(v.begin(), v.end(), 1);
     return v;
 }
 
+template <template <typename> class Alloc>
 void TestTemporaryObjConstructor() {
     const size_t size = 1000000;
     cout << "Test with temporary object, copy elision"s << endl;
-    SimpleVector<int> moved_vector(GenerateVector(size));
+    SimpleVector<int, Alloc<int>> moved_vector(GenerateVector<Alloc>(size));
     assert(moved_vector.GetSize() == size);
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestTemporaryObjOperator() {
     const size_t size = 1000000;
     cout << "Test with temporary object, operator="s << endl;
-    SimpleVector<int> moved_vector;
+    SimpleVector<int, Alloc<int>> moved_vector;
     assert(moved_vector.GetSize() == 0);
-    moved_vector = GenerateVector(size);
+    moved_vector = GenerateVector<Alloc>(size);
     assert(moved_vector.GetSize() == size);
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestNamedMoveConstructor() {
     const size_t size = 1000000;
     cout << "Test with named object, move constructor"s << endl;
-    SimpleVector<int> vector_to_move(GenerateVector(size));
+    SimpleVector<int, Alloc<int>> vector_to_move(GenerateVector<Alloc>(size));
     assert(vector_to_move.GetSize() == size);
 
-    SimpleVector<int> moved_vector(move(vector_to_move));
+    SimpleVector<int, Alloc<int>> moved_vector(move(vector_to_move));
     assert(moved_vector.GetSize() == size);
     assert(vector_to_move.GetSize() == 0);
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestNamedMoveOperator() {
     const size_t size = 1000000;
     cout << "Test with named object, operator="s << endl;
-    SimpleVector<int> vector_to_move(GenerateVector(size));
+    SimpleVector<int, Alloc<int>> vector_to_move(GenerateVector<Alloc>(size));
     assert(vector_to_move.GetSize() == size);
 
-    SimpleVector<int> moved_vector = move(vector_to_move);
+    SimpleVector<int, Alloc<int>> moved_vector = move(vector_to_move);
     assert(moved_vector.GetSize() == size);
     assert(vector_to_move.GetSize() == 0);
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestNoncopiableMoveConstructor() {
     const size_t size = 5;
     cout << "Test noncopiable object, move constructor"s << endl;
-    SimpleVector<X> vector_to_move;
+    SimpleVector<X, Alloc<X>> vector_to_move;
     for (size_t i = 0; i < size; ++i) {
         vector_to_move.PushBack(X(i));
     }
 
-    SimpleVector<X> moved_vector = move(vector_to_move);
+    SimpleVector<X, Alloc<X>> moved_vector = move(vector_to_move);
     assert(moved_vector.GetSize() == size);
     assert(vector_to_move.GetSize() == 0);
 
@@ -98,10 +214,11 @@ void TestNoncopiableMoveConstructor() {
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestNoncopiablePushBack() {
     const size_t size = 5;
     cout << "Test noncopiable push back"s << endl;
-    SimpleVector<X> v;
+    SimpleVector<X, Alloc<X>> v;
     for (size_t i = 0; i < size; ++i) {
         v.PushBack(X(i));
     }
@@ -114,10 +231,11 @@ void TestNoncopiablePushBack() {
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestNoncopiableInsert() {
     const size_t size = 5;
     cout << "Test noncopiable insert"s << endl;
-    SimpleVector<X> v;
+    SimpleVector<X, Alloc<X>> v;
     for (size_t i = 0; i < size; ++i) {
         v.PushBack(X(i));
     }
@@ -137,10 +255,11 @@ void TestNoncopiableInsert() {
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
 void TestNoncopiableErase() {
     const size_t size = 3;
     cout << "Test noncopiable erase"s << endl;
-    SimpleVector<X> v;
+    SimpleVector<X, Alloc<X>> v;
     for (size_t i = 0; i < size; ++i) {
         v.PushBack(X(i));
     }
@@ -150,14 +269,2171 @@ void TestNoncopiableErase() {
     cout << "Done!"s << endl << endl;
 }
 
+template <template <typename> class Alloc>
+void TestUninitializedCapacity() {
+    cout << "Test capacity without element construction"s << endl;
+    {
+        SimpleVector<Counted, Alloc<Counted>> v(Reserve(100));
+        assert(Counted::alive == 0);
+        v.PushBack(Counted(1));
+        v.PushBack(Counted(2));
+        assert(Counted::alive == 2);
+        v.Reserve(1000);
+        assert(Counted::alive == 2);
+        v.Insert(v.begin(), v[1]);
+        assert(v[0].GetValue() == 2 && v[1].GetValue() == 1 && v[2].GetValue() == 2);
+        assert(Counted::alive == 3);
+        v.Erase(v.begin());
+        assert(Counted::alive == 2);
+        v.PopBack();
+        assert(Counted::alive == 1);
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(v[0]);
+        }
+        assert(Counted::alive == 11);
+        v.Clear();
+        assert(Counted::alive == 0);
+        v.PushBack(Counted(3));
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+// Считает копирования и перемещения; копирование может бросить исключение,
+// перемещение не помечено noexcept
+class Tracked {
+public:
+    Tracked(int a, string b)
+        : a_(a), b_(move(b)) {
+    }
+    Tracked(const Tracked& other)
+        : a_(other.a_), b_(other.b_) {
+        if (copies_until_throw >= 0 && copies_until_throw-- == 0) {
+            throw runtime_error("copy failed"s);
+        }
+        ++copies;
+    }
+    Tracked(Tracked&& other)
+        : a_(other.a_), b_(move(other.b_)) {
+        ++moves;
+    }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+
+    int GetA() const {
+        return a_;
+    }
+    const string& GetB() const {
+        return b_;
+    }
+
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static inline int copies_until_throw = -1;
+
+private:
+    int a_;
+    string b_;
+};
+
+void TestEmplace() {
+    cout << "Test emplace"s << endl;
+    SimpleVector<Tracked> v(Reserve(4));
+    Tracked::copies = Tracked::moves = 0;
+    Tracked& first = v.EmplaceBack(1, "one"s);
+    assert(&first == &v[0] && first.GetA() == 1 && first.GetB() == "one"s);
+    v.EmplaceBack(3, "three"s);
+    auto it = v.Emplace(v.begin() + 1, 2, "two"s);
+    assert(it == v.begin() + 1 && it->GetA() == 2);
+    v.Emplace(v.end(), 4, "four"s);
+    // Без перераспределения в конец ничего не копируется и не перемещается
+    assert(Tracked::copies == 0);
+    for (int i = 0; i < 4; ++i) {
+        assert(v[i].GetA() == i + 1);
+    }
+
+    SimpleVector<X> xs;
+    for (size_t i = 0; i < 5; ++i) {
+        xs.EmplaceBack(i);
+    }
+    xs.Emplace(xs.begin(), 10);
+    assert(xs.GetSize() == 6 && xs[0].GetX() == 10 && xs[5].GetX() == 4);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestEmplaceStrongGuarantee() {
+    cout << "Test emplace strong exception guarantee"s << endl;
+    SimpleVector<Tracked> v;
+    v.EmplaceBack(1, "one"s);
+    v.EmplaceBack(2, "two"s);
+    assert(v.GetSize() == v.GetCapacity());
+
+    // Перемещение может бросить, поэтому при перераспределении элементы копируются.
+    // Сбой второй копии должен оставить вектор нетронутым
+    Tracked::copies_until_throw = 1;
+    try {
+        v.EmplaceBack(3, "three"s);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    Tracked::copies_until_throw = -1;
+    assert(v.GetSize() == 2 && v.GetCapacity() == 2);
+    assert(v[0].GetB() == "one"s && v[1].GetB() == "two"s);
+
+    Tracked::copies_until_throw = 0;
+    try {
+        v.Emplace(v.begin(), 0, "zero"s);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    Tracked::copies_until_throw = -1;
+    assert(v.GetSize() == 2 && v[0].GetA() == 1 && v[1].GetA() == 2);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestTriviallyRelocatable() {
+    cout << "Test trivially relocatable elements"s << endl;
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(IsTriviallyRelocatableV<unique_ptr<int>>);
+    static_assert(!IsTriviallyRelocatableV<string>);
+
+    SimpleVector<unique_ptr<int>> ptrs;
+    for (int i = 0; i < 10; ++i) {
+        ptrs.PushBack(make_unique<int>(i));
+    }
+    ptrs.Insert(ptrs.begin(), make_unique<int>(-1));
+    ptrs.Emplace(ptrs.begin() + 5, new int(100));
+    ptrs.Erase(ptrs.begin() + 2);
+    ptrs.Reserve(100);
+    assert(ptrs.GetSize() == 11);
+    assert(*ptrs[0] == -1 && *ptrs[1] == 0 && *ptrs[2] == 2 && *ptrs[4] == 100 && *ptrs[10] == 9);
+
+    SimpleVector<int> ints{1, 2, 3, 4, 5};
+    ints.Insert(ints.begin() + 1, ints[4]);
+    ints.Erase(ints.end() - 1);
+    ints.Insert(ints.end(), 6);
+    assert((ints == SimpleVector<int>{1, 5, 2, 3, 4, 6}));
+    cout << "Done!"s << endl << endl;
+}
+
+void TestGrowthPolicy() {
+    cout << "Test growth policy and shrink to fit"s << endl;
+    SimpleVector<int> doubling;
+    for (int i = 0; i < 5; ++i) {
+        doubling.PushBack(i);
+    }
+    assert(doubling.GetCapacity() == 8);
+
+    SimpleVector<int, allocator<int>, OneAndHalfGrowth> one_and_half;
+    size_t reallocations = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const size_t capacity = one_and_half.GetCapacity();
+        one_and_half.PushBack(i);
+        if (one_and_half.GetCapacity() != capacity) {
+            assert(one_and_half.GetCapacity() == max<size_t>(capacity * 3 / 2, capacity + 1));
+            ++reallocations;
+        }
+    }
+    assert(reallocations < 25);
+
+    SimpleVector<char, allocator<char>, PageRoundedGrowth<>> paged;
+    paged.PushBack('a');
+    assert(paged.GetCapacity() == 4096);
+
+    using Capped = CappedLinearGrowth<1024>;
+    assert(Capped::Next(100, sizeof(int)) == 200);
+    assert(Capped::Next(1000, sizeof(int)) == 1256);
+    assert(GoldenRatioGrowth::Next(1000, 1) == 1618);
+
+    doubling.Resize(100);
+    doubling.Resize(3);
+    assert(doubling.GetCapacity() >= 100);
+    doubling.ShrinkToFit();
+    assert(doubling.GetCapacity() == 3);
+    assert((doubling == SimpleVector<int>{0, 1, 2}));
+    doubling.Clear();
+    assert(doubling.GetCapacity() == 3);
+    doubling.PushBack(1);
+    doubling.Clear(true);
+    assert(doubling.GetCapacity() == 0 && doubling.IsEmpty());
+    doubling.PushBack(7);
+    assert(doubling.GetSize() == 1 && doubling[0] == 7);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestRangeOperations() {
+    cout << "Test range operations"s << endl;
+    const int values[] = {1, 2, 3, 4, 5};
+    SimpleVector<int> ints(begin(values), end(values));
+    assert(ints.GetSize() == 5 && ints.GetCapacity() == 5);
+
+    ints.Reserve(20);
+    const int more[] = {10, 11, 12};
+    auto it = ints.InsertRange(ints.begin() + 1, begin(more), end(more));
+    assert(it == ints.begin() + 1);
+    assert((ints == SimpleVector<int>{1, 10, 11, 12, 2, 3, 4, 5}));
+    ints.Append(begin(more), end(more));
+    it = ints.EraseRange(ints.begin() + 1, ints.begin() + 4);
+    assert(*it == 2);
+    assert((ints == SimpleVector<int>{1, 2, 3, 4, 5, 10, 11, 12}));
+    ints.Assign(begin(more), end(more));
+    assert((ints == SimpleVector<int>{10, 11, 12}) && ints.GetCapacity() == 20);
+
+    // Нетривиальный тип: вставка поворотом и вставка с перераспределением
+    vector<string> words = {"x"s, "y"s};
+    SimpleVector<string> strings{"a"s, "b"s, "c"s};
+    strings.InsertRange(strings.begin() + 1, words.begin(), words.end());
+    assert((strings == SimpleVector<string>{"a"s, "x"s, "y"s, "b"s, "c"s}));
+    strings.Reserve(10);
+    strings.InsertRange(strings.end() - 1, words.begin(), words.end());
+    assert((strings == SimpleVector<string>{"a"s, "x"s, "y"s, "b"s, "x"s, "y"s, "c"s}));
+    strings.EraseRange(strings.begin(), strings.begin() + 3);
+    assert((strings == SimpleVector<string>{"b"s, "x"s, "y"s, "c"s}));
+    strings.Assign(words.begin(), words.begin() + 1);
+    assert((strings == SimpleVector<string>{"x"s}));
+    strings.EraseRange(strings.begin(), strings.begin());
+    assert(strings.GetSize() == 1);
+
+    // Однопроходные итераторы
+    istringstream input("7 8 9"s);
+    SimpleVector<int> from_stream{istream_iterator<int>(input), istream_iterator<int>()};
+    assert((from_stream == SimpleVector<int>{7, 8, 9}));
+    istringstream more_input("1 2"s);
+    from_stream.InsertRange(from_stream.begin(), istream_iterator<int>(more_input), istream_iterator<int>());
+    assert((from_stream == SimpleVector<int>{1, 2, 7, 8, 9}));
+
+    // SimpleVector(size, value) не путается с конструктором из диапазона
+    SimpleVector<int> filled(3, 7);
+    assert((filled == SimpleVector<int>{7, 7, 7}));
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSmallSimpleVector() {
+    cout << "Test small simple vector"s << endl;
+    using Small = SmallSimpleVector<string, 4>;
+    Small v;
+    assert(v.IsInline() && v.GetCapacity() == 4);
+    v.PushBack("b"s);
+    v.Insert(v.begin(), "a"s);
+    v.EmplaceBack(2, 'c');
+    v.Resize(4);
+    assert(v.IsInline() && v.GetSize() == 4);
+    assert(v[0] == "a"s && v[1] == "b"s && v[2] == "cc"s && v[3].empty());
+
+    // Пятый элемент переносит вектор в кучу
+    v.PushBack(v[0]);
+    assert(!v.IsInline() && v.GetSize() == 5 && v[4] == "a"s);
+    v.Erase(v.begin() + 3);
+    v.PopBack();
+    v.ShrinkToFit();
+    assert(v.IsInline());
+    assert((v == Small{"a"s, "b"s, "cc"s}));
+
+    Small copy = v;
+    Small heap(Reserve(10));
+    assert(!heap.IsInline());
+    heap.PushBack("z"s);
+    heap.swap(copy);
+    assert(copy.GetSize() == 1 && heap.GetSize() == 3);
+    assert(heap < copy && copy > heap && heap <= copy && copy >= heap && copy != heap);
+
+    Small moved = move(heap);
+    assert(moved.GetSize() == 3 && heap.GetSize() == 0);
+    moved = Small(10, "x"s);
+    assert(!moved.IsInline() && moved.GetSize() == 10 && moved.At(9) == "x"s);
+    moved.Clear(true);
+    assert(moved.IsInline() && moved.IsEmpty());
+
+    SmallSimpleVector<X, 2> xs;
+    for (size_t i = 0; i < 5; ++i) {
+        xs.PushBack(X(i));
+    }
+    xs.Insert(xs.begin(), X(10));
+    xs.Erase(xs.begin() + 1);
+    assert(xs.GetSize() == 5 && xs[0].GetX() == 10 && xs[1].GetX() == 1);
+
+    {
+        SmallSimpleVector<Counted, 3> counted;
+        counted.PushBack(Counted(1));
+        assert(Counted::alive == 1);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+SIMPLE_VECTOR_STATS_TAG(TestStatsTag);
+
+// Копирование бросает исключение, когда copies_left исчерпан
+struct Fragile {
+    Fragile() = default;
+    Fragile(const Fragile&) {
+        if (--copies_left < 0) {
+            throw runtime_error("copy failed");
+        }
+    }
+    static inline int copies_left = 0;
+};
+
+void TestVectorStats() {
+    cout << "Test vector stats"s << endl;
+    static_assert(sizeof(SimpleVector<int>) == sizeof(SimpleVector<int, allocator<int>, DoublingGrowth, NoStats>));
+    // Метка из макроса регистрируется до первого события
+    assert(VectorStatsRegistry::Instance().ToJson().find("\"TestStatsTag @ "s) != string::npos);
+    using StatsVector = SimpleVector<string, allocator<string>, DoublingGrowth, TaggedStats<TestStatsTag>>;
+    VectorStats& stats = TaggedStats<TestStatsTag>::Counters();
+    stats.Reset();
+    {
+        StatsVector v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(to_string(i));
+        }
+        // Вместимости 1, 2, 4, 8: перенесено 1 + 2 + 4 элементов
+        assert(stats.allocations == 4);
+        assert(stats.bytes_allocated == 15 * sizeof(string));
+        assert(stats.elements_moved == 7 && stats.elements_copied == 0);
+        assert(stats.peak_capacity == 8);
+        assert(stats.buffers_released == 3 && stats.wasted_capacity == 0);
+    }
+    // Последний буфер из 8 ячеек освобождён с 5 элементами
+    assert(stats.buffers_released == 4 && stats.wasted_capacity == 3);
+
+    const string json = VectorStatsRegistry::Instance().ToJson();
+    assert(json.find("\"TestStatsTag @ "s) != string::npos);
+    assert(json.find("\"allocations\":4"s) != string::npos);
+    assert(json.find("\"wasted_capacity\":3"s) != string::npos);
+
+    {
+        // Каждый выделенный буфер учитывается освобождённым ровно один раз, даже если
+        // заполнить его помешало исключение
+        using FragileVector = SimpleVector<Fragile, allocator<Fragile>, DoublingGrowth, TaggedStats<TestStatsTag>>;
+        stats.Reset();
+        Fragile::copies_left = 2;
+        try {
+            FragileVector v(4, Fragile());
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        assert(stats.allocations == 1 && stats.buffers_released == 1);
+
+        Fragile::copies_left = 3;
+        FragileVector v(3, Fragile());
+        v.PopBack();
+        try {
+            v.ShrinkToFit();
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        assert(stats.allocations == 3 && stats.buffers_released == 2 && v.GetCapacity() == 3);
+        Fragile::copies_left = 2;
+        v.ShrinkToFit();
+        assert(stats.allocations == 4 && stats.buffers_released == 3 && v.GetCapacity() == 2);
+    }
+    assert(stats.allocations == stats.buffers_released);
+    cout << "Done!"s << endl << endl;
+}
+
+// Копирование бросает исключение на 501-й копии; копии можно создавать из нескольких потоков
+struct ThrowingCopy {
+    ThrowingCopy() noexcept {
+        alive.fetch_add(1);
+    }
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+    ThrowingCopy(const ThrowingCopy&) {
+        if (copies.fetch_add(1) == 500) {
+            throw runtime_error("copy failed"s);
+        }
+        alive.fetch_add(1);
+    }
+    ~ThrowingCopy() {
+        alive.fetch_sub(1);
+    }
+    static inline atomic<int> copies{0};
+    static inline atomic<int> alive{0};
+};
+
+// Только перемещается, и перемещение бросает исключение на moves_left-м вызове
+struct ThrowingMove {
+    ThrowingMove() noexcept {
+        alive.fetch_add(1);
+    }
+    ThrowingMove(const ThrowingMove&) = delete;
+    ThrowingMove& operator=(ThrowingMove&&) = default;
+    ThrowingMove(ThrowingMove&&) {
+        if (moves_left.fetch_sub(1) == 0) {
+            throw runtime_error("move failed"s);
+        }
+        alive.fetch_add(1);
+    }
+    ~ThrowingMove() {
+        alive.fetch_sub(1);
+    }
+    static inline atomic<int> moves_left{0};
+    static inline atomic<int> alive{0};
+};
+
+// Аллокатор, который выделяет память не больше budget раз, а затем бросает bad_alloc
+template <typename T>
+struct BudgetAllocator {
+    using value_type = T;
+
+    BudgetAllocator() = default;
+    template <typename U>
+    BudgetAllocator(const BudgetAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (budget == 0) {
+            throw bad_alloc();
+        }
+        --budget;
+        return allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const BudgetAllocator&, const BudgetAllocator&) noexcept {
+        return true;
+    }
+    friend bool operator!=(const BudgetAllocator&, const BudgetAllocator&) noexcept {
+        return false;
+    }
+
+    static inline int budget = 0;
+};
+
+void TestParallelAlgorithms() {
+    cout << "Test parallel algorithms"s << endl;
+    ThreadPool pool(3);
+    ParallelOptions options;
+    options.pool = &pool;
+    options.serial_threshold = 100;
+    const size_t size = 100003;
+
+    auto zeros = ParallelMakeVector<int>(size, options);
+    assert(zeros.GetSize() == size && count(zeros.begin(), zeros.end(), 0) == static_cast<ptrdiff_t>(size));
+    auto sevens = ParallelMakeVector<int>(size, 7, options);
+    assert(count(sevens.begin(), sevens.end(), 7) == static_cast<ptrdiff_t>(size));
+    auto words = ParallelMakeVector<string>(1000, "w"s, options);
+    assert(words.GetSize() == 1000 && words[999] == "w"s);
+
+    ParallelIota(zeros, 1, options);
+    for (size_t i = 0; i < size; ++i) {
+        assert(zeros[i] == static_cast<int>(i + 1));
+    }
+    assert(ParallelReduce(zeros, int64_t{0}, plus<>(), options) == int64_t(size) * (size + 1) / 2);
+    assert(ParallelFind(zeros, 5000, options) == zeros.begin() + 4999);
+    assert(ParallelFind(zeros, -1, options) == zeros.end());
+
+    ParallelTransform(zeros, [](int x) { return (x * 7919) % 1000; }, options);
+    ParallelSort(zeros, less<>(), options);
+    assert(is_sorted(zeros.begin(), zeros.end()));
+    ParallelSort(zeros, greater<>(), options);
+    assert(is_sorted(zeros.begin(), zeros.end(), greater<>()));
+
+    ParallelFill(sevens, 1, options);
+    assert(ParallelReduce(sevens, size_t{0}, plus<>(), options) == size);
+    // Куски сворачиваются от нейтрального элемента, а не от своего первого элемента
+    assert(ParallelReduce(sevens, int64_t{5}, plus<>(), options) == int64_t(size) + 5);
+    SimpleVector<uint64_t> factors(size);
+    ParallelIota(factors, uint64_t{1}, options);
+    const auto mul_mod = [](uint64_t acc, uint64_t x) { return acc * x % 1000003; };
+    assert(ParallelReduce(factors, uint64_t{3}, uint64_t{1}, mul_mod, options)
+           == accumulate(factors.begin(), factors.end(), uint64_t{3}, mul_mod));
+
+    // Исключение в одном из кусков: созданные элементы разрушаются, исключение пробрасывается
+    {
+        ThrowingCopy prototype;
+        try {
+            ParallelMakeVector<ThrowingCopy>(1000, prototype, options);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        assert(ThrowingCopy::alive == 1);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestStatefulAllocator() {
+    cout << "Test stateful allocator propagation"s << endl;
+    using Vector = SimpleVector<int, CountingAllocator<int>>;
+    AllocationStats a;
+    AllocationStats b;
+    {
+        Vector va{CountingAllocator<int>(&a)};
+        Vector vb{CountingAllocator<int>(&b)};
+        va.PushBack(1);
+        va.PushBack(2);
+        vb.PushBack(3);
+        assert(a.bytes_in_use > 0 && b.bytes_in_use > 0);
+
+        // propagate_on_container_copy_assignment: vb переходит на аллокатор va
+        vb = va;
+        assert(vb.get_allocator().GetStats() == &a);
+        assert(b.bytes_in_use == 0);
+        assert(vb == va);
+
+        // Копирующий конструктор берёт select_on_container_copy_construction
+        Vector vc(va);
+        assert(vc.get_allocator().GetStats() == &a);
+
+        Vector vd{CountingAllocator<int>(&b)};
+        vd.PushBack(4);
+        vd.swap(vc);
+        assert(vd.get_allocator().GetStats() == &a);
+        assert(vc.get_allocator().GetStats() == &b);
+        assert(vc.GetSize() == 1 && vc[0] == 4);
+
+        vc = move(vd);
+        assert(vc.get_allocator().GetStats() == &a);
+        assert(b.bytes_in_use == 0);
+    }
+    assert(a.bytes_in_use == 0 && a.allocations == a.deallocations);
+    assert(b.bytes_in_use == 0 && b.allocations == b.deallocations);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestPmrSimpleVector() {
+    cout << "Test pmr::SimpleVector"s << endl;
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::monotonic_buffer_resource other_arena;
+    {
+        ::pmr::SimpleVector<std::pmr::string> v(&arena);
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(std::pmr::string(100, static_cast<char>('a' + i)));
+        }
+        // Элементы получают тот же memory_resource, что и вектор
+        for (const auto& str : v) {
+            assert(str.get_allocator().resource() == &arena);
+        }
+
+        // polymorphic_allocator не распространяется при перемещении: элементы переносятся по одному
+        ::pmr::SimpleVector<std::pmr::string> w(&other_arena);
+        w = move(v);
+        assert(w.get_allocator().resource() == &other_arena);
+        assert(w.GetSize() == 10 && w[9] == std::pmr::string(100, 'j'));
+        for (const auto& str : w) {
+            assert(str.get_allocator().resource() == &other_arena);
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestConcurrentSimpleVector() {
+    cout << "Test ConcurrentSimpleVector"s << endl;
+    const size_t thread_count = 4;
+    const size_t per_thread = 20000;
+    {
+        ConcurrentSimpleVector<size_t> v;
+        vector<thread> threads;
+        for (size_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&v, t] {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    const size_t value = t * per_thread + i;
+                    const size_t index = v.PushBack(value);
+                    // Свой элемент можно читать сразу, пока другие потоки добавляют свои
+                    assert(v[index] == value);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        assert(v.GetSize() == thread_count * per_thread && v.GetCapacity() >= v.GetSize());
+
+        const size_t* first_address = &v[0];
+        v.PushBack(0);
+        assert(&v[0] == first_address);
+        v.Clear();
+        assert(v.IsEmpty() && v.GetCapacity() > 0);
+    }
+    {
+        ConcurrentSimpleVector<string> v;
+        vector<thread> threads;
+        for (size_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&v, t] {
+                for (size_t i = 0; i < per_thread / 10; ++i) {
+                    v.EmplaceBack(to_string(t * per_thread + i));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        SimpleVector<string> frozen = v.Freeze();
+        assert(v.IsEmpty() && frozen.GetSize() == thread_count * per_thread / 10);
+        size_t total = 0;
+        for (const string& s : frozen) {
+            total += stoul(s);
+        }
+        size_t expected = 0;
+        for (size_t t = 0; t < thread_count; ++t) {
+            for (size_t i = 0; i < per_thread / 10; ++i) {
+                expected += t * per_thread + i;
+            }
+        }
+        assert(total == expected);
+    }
+    {
+        ConcurrentSimpleVector<int> v;
+        v.Reserve(1000);
+        const size_t capacity = v.GetCapacity();
+        assert(capacity >= 1000);
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.GetCapacity() >= capacity && v.At(999) == 999);
+        try {
+            v.At(1000);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        SimpleVector<int> frozen = v.Freeze();
+        assert(frozen.GetSize() == 1000);
+        for (int i = 0; i < 1000; ++i) {
+            assert(frozen[i] == i);
+        }
+        ConcurrentSimpleVector<int> moved(std::move(v));
+        moved.PushBack(1);
+        assert(moved.GetSize() == 1 && v.IsEmpty());
+    }
+    // Исключение из конструктора копирования: индекс не резервируется
+    {
+        ThrowingCopy::copies = 0;
+        ThrowingCopy::alive = 0;
+        {
+            ThrowingCopy prototype;
+            ConcurrentSimpleVector<ThrowingCopy> v;
+            for (int i = 0; i < 600; ++i) {
+                try {
+                    v.PushBack(prototype);
+                } catch (const runtime_error&) {
+                    assert(i == 500);
+                }
+            }
+            assert(v.GetSize() == 599 && ThrowingCopy::alive == 600);
+
+            // Такие элементы добавляются по одному, но из любых потоков
+            ThrowingCopy::copies = 0;
+            ConcurrentSimpleVector<ThrowingCopy> shared;
+            vector<thread> threads;
+            for (size_t t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&shared, &prototype] {
+                    for (int i = 0; i < 100; ++i) {
+                        shared.PushBack(prototype);
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            assert(shared.GetSize() == 100 * thread_count);
+        }
+        assert(ThrowingCopy::alive == 0);
+    }
+    // Элемент с бросающим конструктором и noexcept-перемещением создаётся до резервирования индекса
+    {
+        struct Checked {
+            explicit Checked(int value)
+                : value(value >= 0 ? value : throw invalid_argument("negative"s)) {
+            }
+            int value;
+        };
+        ConcurrentSimpleVector<Checked> v;
+        assert(v.EmplaceBack(1) == 0);
+        try {
+            v.EmplaceBack(-1);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+        assert(v.GetSize() == 1 && v.EmplaceBack(2) == 1 && v[1].value == 2);
+    }
+    // Нехватка памяти на границе сегмента не резервирует индекс и не выделяет сегмент заранее
+    {
+        BudgetAllocator<int>::budget = 1;
+        ConcurrentSimpleVector<int, BudgetAllocator<int>> v;
+        for (int i = 0; i < 64; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.GetCapacity() == 64);
+        try {
+            v.PushBack(64);
+            assert(false);
+        } catch (const bad_alloc&) {
+        }
+        assert(v.GetSize() == 64 && v[63] == 63);
+        BudgetAllocator<int>::budget = 1;
+        assert(v.PushBack(64) == 64 && v.GetCapacity() == 64 + 128);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestMappedSimpleVector() {
+    cout << "Test MappedSimpleVector"s << endl;
+    const string path = (filesystem::temp_directory_path() / ("simple_vector_test_"s + to_string(getpid()) + ".bin"s)).string();
+    struct Point {
+        int32_t x;
+        int32_t y;
+    };
+    {
+        auto v = MappedSimpleVector<Point>::Create(path);
+        assert(v.IsEmpty() && v.GetCapacity() == 0 && !v.IsReadOnly());
+        for (int i = 0; i < 10000; ++i) {
+            v.PushBack({i, -i});
+        }
+        assert(v.GetSize() == 10000 && v.GetCapacity() >= 10000);
+        v.Insert(v.begin(), {-1, 1});
+        v.Erase(v.begin() + 1);
+        v.PushBack(v[0]);
+        v.PopBack();
+        v.Flush();
+    }
+    {
+        // Повторное открытие видит те же данные без десериализации
+        auto v = MappedSimpleVector<Point>::Open(path, MappedSimpleVector<Point>::Mode::kReadOnly);
+        v.Advise(MappedAccess::kSequential);
+        assert(v.IsReadOnly() && v.GetSize() == 10000);
+        assert(v[0].x == -1 && v[1].x == 1 && v.At(9999).y == -9999);
+        try {
+            v.PushBack({0, 0});
+            assert(false);
+        } catch (const logic_error&) {
+        }
+        try {
+            v.At(10000);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        auto v = MappedSimpleVector<Point>::Open(path);
+        v.Advise(MappedAccess::kRandom);
+        v.Resize(20);
+        v.ShrinkToFit();
+        assert(v.GetSize() == 20 && v.GetCapacity() == 20 && v[19].x == 19);
+        assert(filesystem::file_size(path) == sizeof(MappedVectorHeader) + 20 * sizeof(Point));
+        v.Resize(30);
+        assert(v[29].x == 0 && v[29].y == 0);
+        MappedSimpleVector<Point> moved(std::move(v));
+        assert(moved.GetSize() == 30);
+        moved.Clear();
+        assert(moved.IsEmpty());
+    }
+    // Файл с элементами другого размера не открывается
+    try {
+        MappedSimpleVector<int16_t>::Open(path, MappedSimpleVector<int16_t>::Mode::kReadOnly);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    filesystem::remove(path);
+    cout << "Done!"s << endl;
+}
+
+void TestSerialization() {
+    cout << "Test serialization"s << endl;
+    struct Sample {
+        int32_t id;
+        double value;
+    };
+    {
+        SimpleVector<Sample> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack({i, i * 0.5});
+        }
+        stringstream stream;
+        Serialize(v, stream);
+        auto restored = Deserialize<Sample>(stream);
+        assert(restored.GetSize() == 1000 && restored.GetCapacity() == 1000);
+        for (int i = 0; i < 1000; ++i) {
+            assert(restored[i].id == i && restored[i].value == i * 0.5);
+        }
+
+        stringstream empty_stream;
+        Serialize(SimpleVector<int>(), empty_stream);
+        assert(Deserialize<int>(empty_stream).IsEmpty());
+    }
+    // Потоковая запись кусками без известного заранее размера и чтение кусками другого размера
+    {
+        stringstream stream;
+        VectorStreamWriter<int64_t> writer(stream);
+        SimpleVector<int64_t> chunk(100);
+        for (int64_t part = 0; part < 10; ++part) {
+            iota(chunk.begin(), chunk.end(), part * 100);
+            writer.Write(chunk);
+        }
+        writer.Finish();
+
+        VectorStreamReader<int64_t> reader(stream);
+        assert(reader.GetDeclaredCount() == SerializedVectorHeader::kUnknownCount);
+        SimpleVector<int64_t> part;
+        int64_t expected = 0;
+        while (reader.ReadChunk(part, 64)) {
+            assert(part.GetSize() <= 64);
+            for (int64_t x : part) {
+                assert(x == expected++);
+            }
+        }
+        assert(expected == 1000);
+
+        stream.clear();
+        stream.seekg(0);
+        auto all = Deserialize<int64_t>(stream);
+        assert(all.GetSize() == 1000 && all[999] == 999);
+
+        stream.clear();
+        stream.seekg(0);
+        VectorStreamReader<int64_t> flat_reader(stream);
+        int64_t buffer[333];
+        size_t total = 0;
+        while (size_t n = flat_reader.Read(buffer, 333)) {
+            assert(buffer[0] == static_cast<int64_t>(total));
+            total += n;
+        }
+        assert(total == 1000);
+    }
+    // Повреждённые данные
+    {
+        SimpleVector<int> v(100, 7);
+        stringstream stream;
+        Serialize(v, stream);
+        const string bytes = stream.str();
+        auto expect_error = [](const string& data, auto read) {
+            istringstream in(data);
+            try {
+                read(in);
+                assert(false);
+            } catch (const SerializationError&) {
+            }
+        };
+        auto read_int = [](istream& in) {
+            Deserialize<int>(in);
+        };
+        string flipped = bytes;
+        flipped[sizeof(SerializedVectorHeader) + 8 + 17] ^= 1;
+        expect_error(flipped, read_int);
+        expect_error(bytes.substr(0, bytes.size() - 4), read_int);
+        expect_error("garbage"s + bytes, read_int);
+        expect_error(bytes, [](istream& in) {
+            Deserialize<int16_t>(in);
+        });
+
+        // Огромные числа в заголовке и в размере куска не приводят к огромному выделению
+        auto patch = [](string data, size_t offset, uint64_t value) {
+            memcpy(data.data() + offset, &value, sizeof(value));
+            return data;
+        };
+        const size_t count_offset = offsetof(SerializedVectorHeader, count);
+        const size_t chunk_offset = sizeof(SerializedVectorHeader);
+        expect_error(patch(bytes, count_offset, uint64_t(1) << 58), read_int);
+        expect_error(patch(bytes, count_offset, 50), read_int);
+        expect_error(patch(bytes, chunk_offset, uint64_t(1) << 58), read_int);
+        expect_error(patch(patch(bytes, count_offset, SerializedVectorHeader::kUnknownCount), chunk_offset,
+                           uint64_t(1) << 58),
+                     read_int);
+
+        // Поток с другим порядком байтов отвергается по метке в заголовке
+        string swapped = bytes;
+        const uint32_t swapped_order = SerializedVectorHeader::kSwappedByteOrder;
+        memcpy(swapped.data() + offsetof(SerializedVectorHeader, byte_order), &swapped_order, sizeof(swapped_order));
+        try {
+            istringstream in(swapped);
+            Deserialize<int>(in);
+            assert(false);
+        } catch (const SerializationError& e) {
+            assert(string(e.what()).find("byte order"s) != string::npos);
+        }
+
+        stringstream out;
+        VectorStreamWriter<int> writer(out, 5);
+        writer.Write(v.begin(), 3);
+        try {
+            writer.Finish();
+            assert(false);
+        } catch (const SerializationError&) {
+        }
+    }
+    // Контрольная сумма не зависит от того, какими частями подаются данные
+    {
+        string data(1000, 'x');
+        iota(data.begin(), data.end(), 0);
+        VectorChecksum whole;
+        whole.Update(data.data(), data.size());
+        VectorChecksum parts;
+        for (size_t pos = 0, step = 1; pos < data.size(); pos += step, step = step * 2 + 1) {
+            parts.Update(data.data() + pos, min(step, data.size() - pos));
+        }
+        assert(whole.Finish() == parts.Finish());
+        VectorChecksum other;
+        data[500] ^= 1;
+        other.Update(data.data(), data.size());
+        assert(other.Finish() != whole.Finish());
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestSoASimpleVector() {
+    cout << "Test SoASimpleVector"s << endl;
+    {
+        SoASimpleVector<int, string, double> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i, to_string(i), i * 0.5);
+        }
+        assert(v.GetSize() == 100 && v.GetCapacity() >= 100);
+        auto ids = v.Column<0>();
+        assert(ids.GetSize() == 100 && accumulate(ids.begin(), ids.end(), 0) == 4950);
+        assert(get<1>(v[42]) == "42"s && get<2>(v.At(42)) == 21.0);
+
+        // Изменение через кортеж ссылок и структурные привязки
+        get<1>(v[0]) = "zero"s;
+        for (auto [id, name, value] : v) {
+            value = id * 2.0;
+        }
+        assert(v.Column<2>()[10] == 20.0 && v.Column<1>()[0] == "zero"s);
+
+        auto it = v.Insert(v.begin() + 1, -1, "minus"s, -1.0);
+        assert(it == v.begin() + 1 && v.GetSize() == 101);
+        assert(get<0>(v[0]) == 0 && get<0>(v[1]) == -1 && get<1>(v[2]) == "1"s);
+        // Аргумент ссылается на поле самого вектора
+        v.Insert(v.begin(), get<0>(v[5]), get<1>(v[5]), get<2>(v[5]));
+        assert(get<0>(v[0]) == 4 && get<1>(v[0]) == "4"s);
+
+        it = v.Erase(v.begin() + 2);
+        assert(get<0>(*it) == 1 && v.GetSize() == 101);
+        v.PopBack();
+        assert(get<0>(v[v.GetSize() - 1]) == 98);
+        try {
+            v.At(100);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        const auto& cv = v;
+        assert(count_if(cv.begin(), cv.end(), [](const auto& row) {
+                   return get<0>(row) % 2 == 0;
+               }) == 51);
+
+        SoASimpleVector<int, string, double> copy(v);
+        assert(copy.GetSize() == v.GetSize() && get<1>(copy[3]) == get<1>(v[3]));
+        SoASimpleVector<int, string, double> moved(std::move(copy));
+        assert(copy.IsEmpty() && moved.GetSize() == v.GetSize());
+
+        v.Resize(10);
+        assert(v.GetSize() == 10);
+        v.Resize(20);
+        assert(get<0>(v[19]) == 0 && get<1>(v[19]).empty());
+        v.Clear();
+        assert(v.IsEmpty());
+    }
+    {
+        SoASimpleVector<int, float> v(Reserve(10));
+        assert(v.GetCapacity() == 10 && v.IsEmpty());
+        SoASimpleVector<int, float> sized(5);
+        assert(sized.GetSize() == 5 && sized.Column<1>()[4] == 0.0f);
+    }
+    // Строгая гарантия при перераспределении: исключение при копировании столбца
+    {
+        ThrowingCopy::copies = 0;
+        ThrowingCopy::alive = 0;
+        {
+            SoASimpleVector<int, ThrowingCopy> v;
+            ThrowingCopy prototype;
+            ThrowingCopy::copies = -100000;
+            for (int i = 0; i < 256; ++i) {
+                v.PushBack(i, prototype);
+            }
+            // Следующий PushBack перераспределяет память и копирует столбец ThrowingCopy
+            ThrowingCopy::copies = 300;
+            try {
+                v.PushBack(256, prototype);
+                assert(false);
+            } catch (const runtime_error&) {
+            }
+            assert(v.GetSize() == 256 && v.GetCapacity() == 256 && get<0>(v[255]) == 255);
+            assert(ThrowingCopy::alive == 257);
+        }
+        assert(ThrowingCopy::alive == 0);
+    }
+    // Базовая гарантия: исключение при перемещении некопируемого столбца,
+    // когда соседние столбцы уже скопированы и перемещены
+    {
+        ThrowingCopy::copies = -100000;
+        ThrowingCopy::alive = 0;
+        ThrowingMove::moves_left = 100000;
+        ThrowingMove::alive = 0;
+        {
+            SoASimpleVector<ThrowingCopy, string, ThrowingMove> v;
+            for (int i = 0; i < 64; ++i) {
+                v.PushBack(ThrowingCopy(), string(100, 'x'), ThrowingMove());
+            }
+            ThrowingMove::moves_left = 30;
+            try {
+                v.PushBack(ThrowingCopy(), "last"s, ThrowingMove());
+                assert(false);
+            } catch (const runtime_error&) {
+            }
+            assert(v.GetSize() == 64 && v.GetCapacity() == 64);
+            assert(ThrowingCopy::alive == 64 && ThrowingMove::alive == 64);
+        }
+        assert(ThrowingCopy::alive == 0 && ThrowingMove::alive == 0);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestPersistentSimpleVector() {
+    cout << "Test PersistentSimpleVector"s << endl;
+    {
+        // Размеры пересекают границы хвоста и уровней дерева (32, 32 * 32 + 32, ...)
+        const int size = 40000;
+        PersistentSimpleVector<int> v;
+        vector<PersistentSimpleVector<int>> snapshots;
+        for (int i = 0; i < size; ++i) {
+            if (i % 1000 == 0) {
+                snapshots.push_back(v);
+            }
+            v.PushBack(i);
+        }
+        assert(v.GetSize() == static_cast<size_t>(size) && !v.IsEmpty());
+        for (int i = 0; i < size; ++i) {
+            assert(v[i] == i);
+        }
+        assert(equal(v.begin(), v.end(), begin(vector<int>(v.begin(), v.end()))));
+        assert(v.end() - v.begin() == size && *(v.end() - 1) == size - 1 && v.begin()[777] == 777);
+        // Снимки не видят последующих добавлений
+        for (size_t k = 0; k < snapshots.size(); ++k) {
+            assert(snapshots[k].GetSize() == k * 1000);
+            assert(snapshots[k].GetSize() == 0 || snapshots[k][k * 1000 - 1] == static_cast<int>(k * 1000 - 1));
+        }
+
+        PersistentSimpleVector<int> copy = v;
+        for (int i = 0; i < size; i += 7) {
+            copy.Set(i, -i);
+        }
+        for (int i = 0; i < size; ++i) {
+            assert(v[i] == i);
+            assert(copy[i] == (i % 7 == 0 ? -i : i));
+        }
+
+        // PopBack до пустого вектора, включая схлопывание корня
+        for (int i = size; i > 0; --i) {
+            assert(copy.GetSize() == static_cast<size_t>(i) && copy[i - 1] == ((i - 1) % 7 == 0 ? 1 - i : i - 1));
+            copy.PopBack();
+        }
+        assert(copy.IsEmpty() && copy.begin() == copy.end());
+        assert(v.GetSize() == static_cast<size_t>(size) && v[size - 1] == size - 1);
+        copy.PushBack(5);
+        assert(copy.GetSize() == 1 && copy.At(0) == 5);
+        try {
+            copy.At(1);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        // Попеременные PushBack и PopBack на границе листа
+        PersistentSimpleVector<int> edge;
+        for (int i = 0; i < 32 * 33 + 1; ++i) {
+            edge.PushBack(i);
+        }
+        for (int round = 0; round < 3; ++round) {
+            PersistentSimpleVector<int> before = edge;
+            edge.PopBack();
+            edge.PopBack();
+            edge.PushBack(-1 - round);
+            edge.PushBack(-2 - round);
+            assert(before[32 * 33 - 1] == (round == 0 ? 32 * 33 - 1 : -round));
+            assert(edge[32 * 33 - 1] == -1 - round && edge[32 * 33] == -2 - round && edge[32 * 33 - 2] == 32 * 33 - 2);
+        }
+    }
+    {
+        // Преобразования в SimpleVector и обратно
+        SimpleVector<string> source(100);
+        for (size_t i = 0; i < source.GetSize(); ++i) {
+            source[i] = to_string(i);
+        }
+        PersistentSimpleVector<string> v(source);
+        assert(v.GetSize() == 100 && v[99] == "99"s);
+        SimpleVector<string> back = v.ToSimpleVector();
+        assert(back == source);
+        PersistentSimpleVector<string> small{"a"s, "b"s};
+        assert(small.ToSimpleVector() == SimpleVector<string>({"a"s, "b"s}));
+        assert(PersistentSimpleVector<string>().ToSimpleVector().IsEmpty());
+        PersistentSimpleVector<string> moved = move(v);
+        assert(moved.GetSize() == 100 && v.IsEmpty());
+        moved.swap(v);
+        assert(v.GetSize() == 100 && moved.IsEmpty());
+    }
+    {
+        // Сбой копирования при отделении разделяемых узлов не меняет ни одну из копий
+        ThrowingCopy::copies = -100000;
+        PersistentSimpleVector<ThrowingCopy> v;
+        for (int i = 0; i < 2000; ++i) {
+            v.PushBack(ThrowingCopy());
+        }
+        PersistentSimpleVector<ThrowingCopy> copy = v;
+        const int alive = ThrowingCopy::alive;
+        ThrowingCopy::copies = 490;
+        try {
+            copy.Set(1000, ThrowingCopy());
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        assert(copy.GetSize() == 2000 && v.GetSize() == 2000);
+        assert(ThrowingCopy::alive == alive);
+        ThrowingCopy::copies = -100000;
+        copy.Clear();
+        v.Clear();
+        assert(ThrowingCopy::alive == 0);
+    }
+    {
+        // Копии с общими узлами меняются в разных потоках
+        PersistentSimpleVector<int> base;
+        for (int i = 0; i < 10000; ++i) {
+            base.PushBack(i);
+        }
+        vector<thread> threads;
+        vector<long long> sums(4);
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([copy = base, &sums, t]() mutable {
+                for (int i = t; i < 10000; i += 4) {
+                    copy.Set(i, 0);
+                }
+                for (int i = 0; i < 1000; ++i) {
+                    copy.PushBack(1);
+                }
+                sums[t] = accumulate(copy.begin(), copy.end(), 0LL);
+            });
+        }
+        for (thread& th : threads) {
+            th.join();
+        }
+        const long long total = 10000LL * 9999 / 2;
+        for (int t = 0; t < 4; ++t) {
+            long long removed = 0;
+            for (int i = t; i < 10000; i += 4) {
+                removed += i;
+            }
+            assert(sums[t] == total - removed + 1000);
+        }
+        assert(accumulate(base.begin(), base.end(), 0LL) == total);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestLargePageAllocator() {
+    cout << "Test LargePageAllocator"s << endl;
+    const auto address = [](const auto* p) {
+        return reinterpret_cast<uintptr_t>(p);
+    };
+    {
+        SimpleVector<int, LargePageAllocator<int>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+            assert(address(v.begin()) % 64 == 0);
+        }
+        SimpleVector<int, LargePageAllocator<int>> copy = v;
+        assert(copy == v && address(copy.begin()) % 64 == 0);
+    }
+    {
+        LargePageOptions options;
+        options.alignment = 4096;
+        SimpleVector<char, LargePageAllocator<char>> v(100, 'x', LargePageAllocator<char>(options));
+        assert(address(v.begin()) % 4096 == 0 && v.get_allocator().GetOptions() == options);
+        // Аллокаторы с разными настройками не равны, и перемещающее присваивание их перенимает
+        SimpleVector<char, LargePageAllocator<char>> other;
+        assert(other.get_allocator() != v.get_allocator());
+        other = move(v);
+        assert(other.GetSize() == 100 && other.get_allocator().GetOptions().alignment == 4096);
+    }
+    {
+        LargePageOptions options;
+        options.huge_pages = true;
+        const LargePageAllocator<int64_t> alloc(options);
+        SimpleVector<int64_t, LargePageAllocator<int64_t>> v(alloc);
+        for (int i = 0; i < 300000; ++i) {
+            v.PushBack(i);
+            assert(address(v.begin()) % (2 << 20) == 0);
+        }
+        assert(v[299999] == 299999);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 300000 && v[12345] == 12345);
+
+        ThreadPool pool(3);
+        ParallelOptions parallel;
+        parallel.pool = &pool;
+        parallel.serial_threshold = 1000;
+        auto filled = ParallelMakeVector<int64_t>(1 << 20, int64_t{7}, parallel, alloc);
+        assert(address(filled.begin()) % (2 << 20) == 0 && filled.GetSize() == size_t(1) << 20);
+        assert(ParallelReduce(filled, int64_t{0}, plus<>{}, parallel) == int64_t{7} << 20);
+    }
+    {
+        // Чередование по узлу 0 есть на любой машине; ядро без NUMA отвечает ENOSYS
+        LargePageOptions options;
+        options.numa = NumaPolicy::kInterleave;
+        options.node_mask = 1;
+        try {
+            SimpleVector<int, LargePageAllocator<int>> v(10000, 3, LargePageAllocator<int>(options));
+            assert(v[9999] == 3 && address(v.begin()) % 4096 == 0);
+        } catch (const system_error& e) {
+            assert(e.code().value() == ENOSYS || e.code().value() == EPERM);
+        }
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestCircularSimpleVector() {
+    cout << "Test CircularSimpleVector"s << endl;
+    {
+        // Очередь: кольцо прокручивается, не перераспределяя память
+        CircularSimpleVector<int> queue(Reserve(8));
+        for (int i = 0; i < 1000; ++i) {
+            queue.PushBack(i);
+            if (queue.GetSize() > 5) {
+                assert(queue.Front() == i - 5);
+                queue.PopFront();
+            }
+        }
+        assert(queue.GetCapacity() == 8 && queue.GetSize() == 5 && queue.Front() == 995 && queue.Back() == 999);
+
+        CircularSimpleVector<int> deque;
+        for (int i = 0; i < 100; ++i) {
+            deque.PushBack(i);
+            deque.PushFront(-i - 1);
+        }
+        assert(deque.GetSize() == 200 && deque.Front() == -100 && deque.Back() == 99);
+        for (int i = 0; i < 200; ++i) {
+            assert(deque[i] == i - 100);
+        }
+        assert(is_sorted(deque.begin(), deque.end()) && deque.end() - deque.begin() == 200);
+        assert(*(deque.begin() + 150) == 50 && deque.cbegin()[10] == -90);
+        sort(deque.begin(), deque.end(), greater<>());
+        assert(deque.Front() == 99 && deque.Back() == -100);
+        try {
+            deque.At(200);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        // Вставка и удаление в середине кольца, перешедшего через границу буфера
+        CircularSimpleVector<string> v(Reserve(16));
+        vector<string> expected;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(to_string(i));
+            v.PopFront();
+        }
+        mt19937 gen(7);
+        for (int step = 0; step < 2000; ++step) {
+            const size_t pos = expected.empty() ? 0 : gen() % (expected.size() + 1);
+            if (gen() % 3 != 0 || expected.empty()) {
+                const string value = to_string(step);
+                auto it = v.Insert(v.begin() + pos, value);
+                assert(*it == value);
+                expected.insert(expected.begin() + pos, value);
+            } else {
+                const size_t erase_pos = pos % expected.size();
+                auto it = v.Erase(v.cbegin() + erase_pos);
+                assert(it - v.begin() == static_cast<ptrdiff_t>(erase_pos));
+                expected.erase(expected.begin() + erase_pos);
+            }
+            assert(v.GetSize() == expected.size());
+        }
+        assert(equal(v.begin(), v.end(), expected.begin()));
+        CircularSimpleVector<string> copy = v;
+        assert(copy == v && !(copy < v));
+        copy.PopFront();
+        assert(copy != v);
+        v.Resize(3);
+        assert(v.GetSize() == 3 && v[2] == expected[2]);
+        v.Resize(5);
+        assert(v[4].empty());
+    }
+    {
+        // Рост кольца с Insert, аргумент которого ссылается на элемент самого кольца
+        CircularSimpleVector<string> v{"a"s, "b"s, "c"s};
+        assert(v.IsFull());
+        v.Insert(v.begin() + 1, v[2]);
+        v.PushFront(v.Back());
+        assert((v == CircularSimpleVector<string>{"c"s, "a"s, "c"s, "b"s, "c"s}));
+    }
+    {
+        // Окно последних значений
+        RingWindow<int> window(Reserve(4));
+        for (int i = 0; i < 10; ++i) {
+            window.PushBack(i);
+        }
+        assert(window.GetCapacity() == 4 && (window == RingWindow<int>{6, 7, 8, 9}));
+        window.PushFront(100);
+        assert((window == RingWindow<int>{100, 6, 7, 8}));
+        window.Insert(window.begin() + 2, 50);
+        assert((window == RingWindow<int>{6, 50, 7, 8}));
+        window.Reserve(6);
+        window.PushBack(9);
+        window.PushBack(10);
+        window.PushBack(11);
+        assert((window == RingWindow<int>{50, 7, 8, 9, 10, 11}));
+    }
+    {
+        // Кольцу без вместимости некуда записывать
+        RingWindow<string> window;
+        try {
+            window.PushBack("a"s);
+            assert(false);
+        } catch (const length_error&) {
+        }
+        try {
+            window.EmplaceFront("b"s);
+            assert(false);
+        } catch (const length_error&) {
+        }
+        assert(window.IsEmpty() && window.GetCapacity() == 0);
+    }
+    {
+        // Сбой копирования при росте оставляет кольцо нетронутым
+        ThrowingCopy::copies = -100000;
+        CircularSimpleVector<ThrowingCopy> v(Reserve(600));
+        for (int i = 0; i < 600; ++i) {
+            v.PushBack(ThrowingCopy());
+            if (i % 2 == 0) {
+                v.PushFront(ThrowingCopy());
+                v.PopBack();
+            }
+        }
+        const int alive = ThrowingCopy::alive;
+        ThrowingCopy::copies = 0;
+        try {
+            v.PushBack(ThrowingCopy());
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        assert(v.GetSize() == 600 && v.GetCapacity() == 600 && ThrowingCopy::alive == alive);
+        ThrowingCopy::copies = -100000;
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestBitVector() {
+    cout << "Test BitVector"s << endl;
+    {
+        BitVector bits;
+        vector<bool> expected;
+        mt19937 gen(11);
+        for (int i = 0; i < 1000; ++i) {
+            const bool bit = gen() % 3 == 0;
+            bits.PushBack(bit);
+            expected.push_back(bit);
+        }
+        assert(bits.GetSize() == 1000 && bits.GetCapacity() >= 1000 && bits.GetWordCount() == 16);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(bits[i] == expected[i]);
+        }
+        assert(bits.Count() == static_cast<size_t>(count(expected.begin(), expected.end(), true)));
+
+        // Прокси-ссылка меняет только свой бит
+        bits[5] = true;
+        bits[6] = false;
+        bits[7] = bits[5];
+        bits.At(8).Flip();
+        expected[5] = true;
+        expected[6] = false;
+        expected[7] = true;
+        expected[8] = !expected[8];
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(bits[i] == expected[i]);
+        }
+        try {
+            bits.At(1000);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        // FindFirst/FindNext перебирают ровно установленные биты
+        vector<size_t> ones;
+        for (size_t i = bits.FindFirst(); i < bits.GetSize(); i = bits.FindNext(i)) {
+            ones.push_back(i);
+        }
+        vector<size_t> expected_ones;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (expected[i]) {
+                expected_ones.push_back(i);
+            }
+        }
+        assert(ones == expected_ones);
+
+        RankSelect index(bits);
+        assert(index.GetOnes() == expected_ones.size() && index.Rank(0) == 0 && index.Rank(1000) == expected_ones.size());
+        size_t rank = 0;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(index.Rank(i) == rank);
+            rank += expected[i];
+        }
+        for (size_t k = 0; k < expected_ones.size(); ++k) {
+            assert(index.Select(k) == expected_ones[k]);
+        }
+        assert(index.Select(expected_ones.size()) == bits.GetSize());
+
+        for (int i = 0; i < 300; ++i) {
+            bits.PopBack();
+        }
+        assert(bits.GetSize() == 700 && bits.Count() == RankSelect(bits).Rank(700));
+    }
+    {
+        // Хвостовые биты последнего слова не влияют на Count, сравнение и Not
+        BitVector a(130, true);
+        assert(a.Count() == 130 && a.All() && a.Any());
+        a.Not();
+        assert(a.Count() == 0 && a.None() && a.FindFirst() == 130);
+        a.Resize(200, true);
+        assert(a.Count() == 70 && a.FindFirst() == 130 && !a[129] && a[199]);
+        a.Resize(131);
+        assert(a.Count() == 1);
+        a.Resize(200);
+        assert(a.Count() == 1 && !a[131]);
+        assert(BitVector(65, false) != BitVector(64, false));
+
+        BitVector x{true, true, false, false, true};
+        const BitVector y{true, false, true, false, true};
+        BitVector t = x;
+        assert((t.And(y) == BitVector{true, false, false, false, true}));
+        t = x;
+        assert((t.Or(y) == BitVector{true, true, true, false, true}));
+        t = x;
+        assert((t.Xor(y) == BitVector{false, true, true, false, false}));
+        t = x;
+        assert((t.AndNot(y) == BitVector{false, true, false, false, false}));
+
+        // Длинные векторы проходят через векторизованные ядра
+        BitVector p(10000);
+        BitVector q(10000);
+        for (size_t i = 0; i < 10000; i += 3) {
+            p.Set(i);
+        }
+        for (size_t i = 0; i < 10000; i += 5) {
+            q.Set(i);
+        }
+        BitVector both = p;
+        both.And(q);
+        assert(both.Count() == 667 && both.FindNext(0) == 15);
+        p.Or(q);
+        assert(p.Count() == 3334 + 2000 - 667);
+        p.Not();
+        assert(p.Count() == 10000 - (3334 + 2000 - 667) && !p[0] && p[1]);
+        p.Clear();
+        assert(p.IsEmpty() && p.Count() == 0);
+        BitVector reserved(Reserve(1000));
+        assert(reserved.IsEmpty() && reserved.GetCapacity() >= 1000);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestPackedIntVector() {
+    cout << "Test PackedIntVector"s << endl;
+    {
+        // Небольшие случайные значения: кодировка kFrameOfReference
+        PackedIntVector<uint64_t> packed;
+        vector<uint64_t> expected;
+        mt19937_64 gen(17);
+        for (int i = 0; i < 5000; ++i) {
+            const uint64_t value = 1000000 + gen() % 1000;
+            packed.PushBack(value);
+            expected.push_back(value);
+        }
+        assert(packed.GetSize() == 5000 && packed.GetBlockCount() == 19);
+        assert(packed.GetBlockEncoding(0) == PackedIntVector<uint64_t>::Encoding::kFrameOfReference);
+        assert(packed.GetBlockWidth(0) == 10);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(packed[i] == expected[i]);
+        }
+        assert(equal(packed.begin(), packed.end(), expected.begin(), expected.end()));
+        packed.ShrinkToFit();
+        assert(packed.GetMemoryUsage() < expected.size() * sizeof(uint64_t) / 4);
+        try {
+            packed.At(5000);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        vector<uint64_t> decoded(1000);
+        packed.Decode(4100, 900, decoded.data());
+        assert(equal(decoded.begin(), decoded.begin() + 900, expected.begin() + 4100));
+
+        // Сокращение в середину запечатанного блока и рост обратно
+        packed.Resize(1000);
+        expected.resize(1000);
+        assert(packed.GetSize() == 1000 && packed.GetBlockCount() == 3);
+        assert(equal(packed.begin(), packed.end(), expected.begin(), expected.end()));
+        packed.Resize(1300, 7);
+        expected.resize(1300, 7);
+        assert(equal(packed.begin(), packed.end(), expected.begin(), expected.end()));
+        while (packed.GetSize() > 700) {
+            assert(packed.Back() == expected.back());
+            packed.PopBack();
+            expected.pop_back();
+        }
+        assert(equal(packed.begin(), packed.end(), expected.begin(), expected.end()));
+        packed.Clear();
+        assert(packed.IsEmpty() && packed.begin() == packed.end());
+    }
+    {
+        // Возрастающая последовательность с большими значениями: кодировка kDelta
+        PackedIntVector<uint64_t> packed(Reserve(3000));
+        vector<uint64_t> expected;
+        uint64_t value = uint64_t(1) << 60;
+        for (int i = 0; i < 3000; ++i) {
+            value += i % 50;
+            packed.PushBack(value);
+            expected.push_back(value);
+        }
+        assert(packed.GetBlockEncoding(0) == PackedIntVector<uint64_t>::Encoding::kDelta);
+        assert(packed.GetBlockWidth(0) <= 8);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(packed[i] == expected[i]);
+        }
+        assert(equal(packed.begin(), packed.end(), expected.begin(), expected.end()));
+
+        // Итератор с произвольным доступом и обход в обратную сторону
+        auto it = packed.begin() + 2000;
+        assert(*it == expected[2000] && it[-1000] == expected[1000] && packed.end() - it == 1000);
+        size_t index = expected.size();
+        for (auto rit = packed.end(); rit != packed.begin();) {
+            assert(*--rit == expected[--index]);
+        }
+    }
+    {
+        // Знаковые значения и значения на всю ширину слова
+        PackedIntVector<int8_t> bytes;
+        vector<int8_t> expected_bytes;
+        PackedIntVector<int64_t> wide;
+        vector<int64_t> expected_wide;
+        mt19937_64 gen(23);
+        for (int i = 0; i < 1000; ++i) {
+            const auto byte = static_cast<int8_t>(gen());
+            bytes.PushBack(byte);
+            expected_bytes.push_back(byte);
+            const int64_t number = i % 3 == 0 ? numeric_limits<int64_t>::min() : numeric_limits<int64_t>::max();
+            wide.PushBack(i < 512 ? number : -i);
+            expected_wide.push_back(i < 512 ? number : -i);
+        }
+        assert(equal(bytes.begin(), bytes.end(), expected_bytes.begin(), expected_bytes.end()));
+        assert(wide.GetBlockWidth(0) == 64);
+        assert(wide.GetBlockEncoding(2) == PackedIntVector<int64_t>::Encoding::kFrameOfReference);
+        for (size_t i = 0; i < expected_wide.size(); ++i) {
+            assert(wide[i] == expected_wide[i]);
+        }
+        assert(equal(wide.begin(), wide.end(), expected_wide.begin(), expected_wide.end()));
+    }
+    {
+        // Одинаковые значения занимают ноль битов
+        PackedIntVector<uint32_t> same(1024, 42);
+        assert(same.GetBlockCount() == 3 && same.GetBlockWidth(0) == 0);
+        assert(count(same.begin(), same.end(), 42u) == 1024);
+
+        PackedIntVector<uint32_t> other{1, 2, 3};
+        PackedIntVector<uint32_t> copy = other;
+        assert(copy == other && copy != same);
+        copy.swap(same);
+        assert(same == other && copy.GetSize() == 1024);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestRecyclingAllocator() {
+    cout << "Test RecyclingAllocator"s << endl;
+    BufferRecycler& recycler = BufferRecycler::Instance();
+    recycler.Trim();
+    assert(recycler.GetStats().retained_bytes == 0);
+    {
+        // Буфер уничтоженного вектора достаётся следующему вектору того же размерного класса
+        const RecyclerStats before = recycler.GetStats();
+        const int* first_buffer = nullptr;
+        for (int round = 0; round < 100; ++round) {
+            recycling::SimpleVector<int> v(Reserve(100));
+            for (int i = 0; i < 100; ++i) {
+                v.PushBack(i);
+            }
+            assert(v[99] == 99 && v.GetCapacity() == 100);
+            if (round == 0) {
+                first_buffer = v.begin();
+            } else {
+                assert(v.begin() == first_buffer);
+            }
+        }
+        const RecyclerStats after = recycler.GetStats();
+        assert(after.misses - before.misses == 1);
+        assert(after.thread_hits - before.thread_hits == 99);
+        assert(after.retained_buffers == 1 && after.retained_bytes == 512);
+        assert(after.HitRate() > 0.0);
+    }
+    {
+        // Рост через PushBack и Resize тоже берёт буферы из кеша
+        recycling::SimpleVector<uint64_t> warm;
+        for (int i = 0; i < 1000; ++i) {
+            warm.PushBack(i);
+        }
+        warm.Clear(true);
+        const RecyclerStats before = recycler.GetStats();
+        recycling::SimpleVector<uint64_t> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        v.Resize(2000);
+        assert(v[999] == 999 && v[1999] == 0);
+        const RecyclerStats after = recycler.GetStats();
+        assert(after.misses - before.misses == 1);
+        assert(after.thread_hits - before.thread_hits == 11);
+    }
+    {
+        // Лимит потока: лишние буферы уходят в общий пул, а сверх его лимита освобождаются
+        const RecyclerLimits defaults = recycler.GetLimits();
+        recycler.Trim();
+        recycler.SetLimits({2, 1});
+        {
+            vector<recycling::SimpleVector<char>> vectors;
+            for (int i = 0; i < 6; ++i) {
+                vectors.emplace_back(Reserve(1000));
+            }
+        }
+        assert(recycler.GetStats().retained_buffers <= 3);
+        recycler.SetLimits(defaults);
+        assert(recycler.GetLimits().thread_buffers_per_class == defaults.thread_buffers_per_class);
+    }
+    {
+        // Кеш завершившегося потока переходит в общий пул
+        recycler.Trim();
+        thread worker([] {
+            recycling::SimpleVector<double> v(Reserve(3000));
+            v.PushBack(1.0);
+        });
+        worker.join();
+        assert(recycler.GetStats().retained_bytes == 32768);
+        const RecyclerStats before = recycler.GetStats();
+        recycling::SimpleVector<double> v(Reserve(3000));
+        assert(recycler.GetStats().global_hits - before.global_hits == 1);
+    }
+    {
+        // Большие буферы и типы с особым выравниванием идут мимо кешей
+        const RecyclerStats before = recycler.GetStats();
+        recycling::SimpleVector<char> big(Reserve(size_t(2) << 20));
+        assert(recycler.GetStats().bypassed - before.bypassed == 1);
+        struct alignas(64) Line {
+            char data[64];
+        };
+        recycling::SimpleVector<Line> lines(3);
+        assert(reinterpret_cast<uintptr_t>(lines.begin()) % 64 == 0);
+    }
+    recycler.Trim();
+    assert(recycler.GetStats().retained_bytes == 0 && recycler.GetStats().retained_buffers == 0);
+    cout << "Done!"s << endl;
+}
+
+void TestVectorExpressions() {
+    cout << "Test vector expressions"s << endl;
+    {
+        const SimpleVector<double> a{1.0, 2.0, 3.0, 4.0, 5.0};
+        const SimpleVector<double> b{10.0, 20.0, 30.0, 40.0, 50.0};
+        const SimpleVector<double> c{0.5, 0.5, 0.5, 0.5, 0.5};
+
+        // Выражение ничего не вычисляет до присваивания
+        const auto expr = a * 2.0 + b - c;
+        assert(expr.GetSize() == 5 && expr[1] == 23.5);
+        SimpleVector<double> d = expr;
+        assert((d == SimpleVector<double>{11.5, 23.5, 35.5, 47.5, 59.5}));
+
+        d = -a / 2 + 1;
+        assert((d == SimpleVector<double>{0.5, 0.0, -0.5, -1.0, -1.5}));
+        d = Abs(d) + Sqrt(b * b * 0.0 + 16.0 * c * 2.0);
+        assert((d == SimpleVector<double>{4.5, 4.0, 4.5, 5.0, 5.5}));
+        d = Max(Min(a, 4.0), 2);
+        assert((d == SimpleVector<double>{2.0, 2.0, 3.0, 4.0, 4.0}));
+        d = Log(Exp(a));
+        for (size_t i = 0; i < a.GetSize(); ++i) {
+            assert(abs(d[i] - a[i]) < 1e-12);
+        }
+
+        // Свёртки принимают и векторы, и выражения
+        assert(Sum(a) == 15.0 && Sum(a * b) == 550.0 && Dot(a, b) == 550.0);
+        assert(Reduce(a - 1.0, 1.0, multiplies<>()) == 0.0);
+        assert(Reduce(a + 1.0, 1.0, multiplies<>()) == 720.0);
+    }
+    {
+        // Вычисление в вектор-операнд идёт на месте, без новой памяти
+        SimpleVector<int> a(1000);
+        iota(a.begin(), a.end(), 0);
+        const SimpleVector<int> b(1000, 3);
+        const int* buffer = a.begin();
+        a = a * b + a;
+        assert(a.begin() == buffer && a[999] == 3996);
+        a -= b;
+        a *= 2;
+        a /= 4;
+        a += a;
+        assert(a.begin() == buffer && a[0] == -2 && a[10] == 36);
+
+        // Смешение типов: результат приводится к типу вектора-приёмника
+        const SimpleVector<uint8_t> bytes(1000, 200);
+        SimpleVector<int> wide = bytes + bytes;
+        assert(wide[0] == 400);
+        const SimpleVector<double> halves = a * 0.5;
+        assert(halves[10] == 18.0);
+        const SimpleVector<int64_t> sums(10, int64_t(1) << 40);
+        assert(Sum(sums) == int64_t(10) << 40);
+    }
+    {
+        // Размеры проверяются при построении выражения
+        const SimpleVector<float> a(10, 1.0f);
+        const SimpleVector<float> b(11, 1.0f);
+        try {
+            static_cast<void>(a + b * 2.0f);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+        SimpleVector<float> empty;
+        empty = empty * 3.0f;
+        assert(empty.IsEmpty() && Sum(empty) == 0.0f);
+        SimpleVector<float> resized = a * 2.0f;
+        resized = b - 1.0f;
+        assert(resized.GetSize() == 11 && resized[10] == 0.0f);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestAdoptAndRelease() {
+    cout << "Test adopt and release"s << endl;
+    {
+        // Буфер сетевого слоя: память из malloc, освобождается через free
+        int freed = 0;
+        auto* data = static_cast<uint32_t*>(malloc(16 * sizeof(uint32_t)));
+        iota(data, data + 10, 0u);
+        SimpleVector<uint32_t> v{7u, 7u};
+        v.Adopt(data, 10, 16, [&freed](uint32_t* ptr, size_t capacity) {
+            assert(capacity == 16);
+            ++freed;
+            free(ptr);
+        });
+        assert(v.begin() == data && v.GetSize() == 10 && v.GetCapacity() == 16 && v[9] == 9u);
+
+        // Свободные ячейки заполняются без копирования, при росте чужая память возвращается
+        for (uint32_t i = 10; i < 16; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.begin() == data && freed == 0);
+        v.PushBack(16u);
+        assert(v.begin() != data && freed == 1 && v[16] == 16u && v.GetCapacity() == 32);
+    }
+    {
+        // Release отдаёт буфер декодеру, Adopt забирает обратно
+        SimpleVector<string> v;
+        v.Reserve(8);
+        v.PushBack("alpha"s);
+        v.PushBack("beta"s);
+        const string* buffer = v.begin();
+        auto released = v.Release();
+        assert(v.IsEmpty() && v.GetCapacity() == 0 && v.begin() == nullptr);
+        assert(released.data == buffer && released.size == 2 && released.capacity == 8);
+        // Память аллокатора не требует функции освобождения
+        assert(!released.deleter && released.context == nullptr);
+
+        new (released.data + 2) string("gamma"s);
+        SimpleVector<string> w;
+        w.Adopt(released.data, 3, released.capacity, released.deleter, released.context);
+        assert(w.begin() == buffer && (w == SimpleVector<string>{"alpha"s, "beta"s, "gamma"s}));
+
+        // Без deleter память считается выделенной аллокатором вектора
+        auto again = w.Release();
+        SimpleVector<string> u;
+        u.Adopt(again.data, again.size, again.capacity);
+        assert(u.begin() == buffer && u.GetSize() == 3);
+
+        // Получатель сам разрушает элементы и освобождает память
+        auto last = u.Release();
+        for (size_t i = 0; i < last.size; ++i) {
+            last.data[i].~string();
+        }
+        last.Free();
+
+        auto nothing = SimpleVector<string>().Release();
+        assert(nothing.data == nullptr && !nothing.deleter);
+    }
+    {
+        // Перемещение и обмен переносят и функцию освобождения
+        int freed = 0;
+        auto deleter = [&freed](double* ptr, size_t) {
+            ++freed;
+            delete[] ptr;
+        };
+        SimpleVector<double> a;
+        a.Adopt(new double[4]{1.0, 2.0, 3.0, 4.0}, 4, 4, deleter);
+        SimpleVector<double> b(std::move(a));
+        SimpleVector<double> c{5.0};
+        c.swap(b);
+        assert(c.GetSize() == 4 && c[3] == 4.0 && b.GetSize() == 1);
+        c.Clear(true);
+        assert(freed == 1 && c.GetCapacity() == 0);
+        b.Adopt(new double[2]{6.0, 7.0}, 2, 2, deleter);
+        b = SimpleVector<double>{8.0};
+        assert(freed == 2 && b[0] == 8.0);
+
+        // Release чужого буфера отдаёт его функцию освобождения вместе с контекстом
+        b.Adopt(new double[3]{1.0, 2.0, 3.0}, 3, 3, deleter);
+        auto released = b.Release();
+        assert(released.deleter != nullptr && released.context != nullptr && freed == 2);
+        released.Free();
+        assert(freed == 3 && released.data == nullptr);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestSimpleVectorView() {
+    cout << "Test simple vector view"s << endl;
+    {
+        SimpleVector<int> v(10);
+        iota(v.begin(), v.end(), 0);
+        SimpleVectorView view = v;
+        static_assert(is_same_v<decltype(view), SimpleVectorView<int>>);
+        assert(view.Data() == v.begin() && view.GetSize() == 10);
+
+        // Срезы ссылаются на память вектора
+        auto middle = view.Subview(2, 5);
+        assert(middle.GetSize() == 5 && middle[0] == 2 && middle.At(4) == 6);
+        middle[1] = 30;
+        assert(v[3] == 30);
+        assert(view.Subview(7).GetSize() == 3 && view.Subview(10).IsEmpty());
+        assert(view.First(3)[2] == 2 && view.Last(2)[0] == 8 && view.Last(0).IsEmpty());
+        assert(accumulate(middle.begin(), middle.end(), 0) == 2 + 30 + 4 + 5 + 6);
+
+        try {
+            view.Subview(11);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        try {
+            view.Last(11);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        try {
+            middle.At(5);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        const SimpleVector<int>& cv = v;
+        SimpleVectorView read_only = cv;
+        static_assert(is_same_v<decltype(read_only), SimpleVectorView<const int>>);
+        SimpleVectorView<const int> converted = middle;
+        assert(converted.Data() == v.begin() + 2 && read_only[3] == 30);
+    }
+    {
+        // Чередующиеся отсчёты двух каналов: левый и правый канал без копирования
+        SimpleVector<int> samples{0, 100, 1, 101, 2, 102, 3, 103, 4};
+        const SimpleVectorView<int> all = samples;
+        auto left = all.Strided(2);
+        auto right = all.Subview(1).Strided(2);
+        assert(left.GetSize() == 5 && right.GetSize() == 4 && left.GetStride() == 2);
+        assert(left[4] == 4 && right.At(3) == 103);
+        assert((vector<int>(right.begin(), right.end()) == vector<int>{100, 101, 102, 103}));
+        assert(right.end() - right.begin() == 4 && *(left.begin() + 3) == 3);
+
+        for (int& sample : right) {
+            sample -= 100;
+        }
+        assert(samples[7] == 3);
+        auto every_fourth = left.Strided(2);
+        assert(every_fourth.GetSize() == 3 && every_fourth.GetStride() == 4 && every_fourth[2] == 4);
+        assert(left.Subview(1, 2)[1] == 2 && left.Last(2)[0] == 3 && left.First(1)[0] == 0);
+        assert(left.Subview(5).IsEmpty() && left.Last(0).IsEmpty());
+
+        StridedView<const int> readonly_left = left;
+        assert(accumulate(readonly_left.begin(), readonly_left.end(), 0) == 10);
+        try {
+            all.Strided(0);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+        SimpleVectorView<int> empty;
+        assert(empty.Strided(3).IsEmpty() && empty.Subview(0).IsEmpty());
+    }
+    cout << "Done!"s << endl;
+}
+
+// Сверяет ядра simd.h для всех доступных наборов инструкций со стандартными алгоритмами
+template <typename T>
+void CheckSimdKernels(const vector<T>& a, const vector<T>& b, T needle) {
+    const size_t n = a.size();
+    const size_t not_equal = mismatch(a.begin(), a.end(), b.begin()).first - a.begin();
+    size_t different = 0;
+    while (different < n && !(a[different] < b[different]) && !(b[different] < a[different])) {
+        ++different;
+    }
+    const size_t found = find(a.begin(), a.end(), needle) - a.begin();
+    const size_t counted = count(a.begin(), a.end(), needle);
+    auto check = [&](auto find_first_not_equal, auto find_first_different, auto find_value, auto count_value) {
+        assert(find_first_not_equal(a.data(), b.data(), n) == not_equal);
+        assert(find_first_different(a.data(), b.data(), n) == different);
+        assert(find_value(a.data(), n, needle) == found);
+        assert(count_value(a.data(), n, needle) == counted);
+    };
+    check(simd::scalar::FindFirstNotEqual<T>, simd::scalar::FindFirstDifferent<T>, simd::scalar::Find<T>, simd::scalar::Count<T>);
+#ifdef SIMPLE_VECTOR_X86_SIMD
+    if (__builtin_cpu_supports("sse4.2")) {
+        check(simd::sse42::FindFirstNotEqual<T>, simd::sse42::FindFirstDifferent<T>, simd::sse42::Find<T>, simd::sse42::Count<T>);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        check(simd::avx2::FindFirstNotEqual<T>, simd::avx2::FindFirstDifferent<T>, simd::avx2::Find<T>, simd::avx2::Count<T>);
+    }
+#endif
+    if constexpr (simd::kHasVectorMinMax<T>) {
+        if (n > 0) {
+            const T min_value = *min_element(a.begin(), a.end());
+            const T max_value = *max_element(a.begin(), a.end());
+            assert(simd::MinValue(a.data(), n) == min_value && simd::MaxValue(a.data(), n) == max_value);
+#ifdef SIMPLE_VECTOR_X86_SIMD
+            if (__builtin_cpu_supports("sse4.2")) {
+                assert(simd::sse42::MinValue(a.data(), n) == min_value && simd::sse42::MaxValue(a.data(), n) == max_value);
+            }
+            if (__builtin_cpu_supports("avx2")) {
+                assert(simd::avx2::MinValue(a.data(), n) == min_value && simd::avx2::MaxValue(a.data(), n) == max_value);
+            }
+#endif
+        }
+    }
+}
+
+template <typename T>
+void CheckSimdKernelsForType() {
+    mt19937 gen(42);
+    for (size_t n : {0, 1, 7, 15, 16, 31, 32, 33, 64, 100, 257}) {
+        vector<T> a(n);
+        for (T& x : a) {
+            // Узкий диапазон, чтобы искомое значение встречалось несколько раз
+            x = static_cast<T>(static_cast<int>(gen() % 8) - 3);
+        }
+        if (n > 2) {
+            a[n / 2] = numeric_limits<T>::max();
+            a[n - 1] = numeric_limits<T>::lowest();
+        }
+        CheckSimdKernels(a, a, T(1));
+        for (size_t pos = 0; pos < n; pos += 1 + n / 5) {
+            vector<T> b = a;
+            b[pos] = b[pos] == T(5) ? T(6) : T(5);
+            CheckSimdKernels(a, b, T(-3));
+            CheckSimdKernels(b, a, T(100));
+        }
+    }
+}
+
+void TestSimdKernels() {
+    cout << "Test SIMD kernels"s << endl;
+    CheckSimdKernelsForType<int8_t>();
+    CheckSimdKernelsForType<uint8_t>();
+    CheckSimdKernelsForType<int16_t>();
+    CheckSimdKernelsForType<uint16_t>();
+    CheckSimdKernelsForType<int32_t>();
+    CheckSimdKernelsForType<uint32_t>();
+    CheckSimdKernelsForType<int64_t>();
+    CheckSimdKernelsForType<uint64_t>();
+    CheckSimdKernelsForType<float>();
+    CheckSimdKernelsForType<double>();
+
+    // NaN не равен себе, но и не меньше и не больше другого элемента
+    {
+        const double nan = numeric_limits<double>::quiet_NaN();
+        vector<double> a(40, 1.0);
+        vector<double> b = a;
+        a[35] = b[35] = nan;
+        CheckSimdKernels(a, b, nan);
+        b[37] = 0.0;
+        CheckSimdKernels(a, b, 1.0);
+        // -0.0 и 0.0 равны, хотя их байты различаются
+        vector<double> zeros(40, 0.0);
+        vector<double> negative_zeros(40, -0.0);
+        CheckSimdKernels(zeros, negative_zeros, -0.0);
+    }
+
+    // Ядра над словами битов, включая хвост короче вектора
+    {
+        mt19937_64 gen(5);
+        vector<uint64_t> a(37);
+        vector<uint64_t> b(37);
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = gen();
+            b[i] = gen();
+        }
+        size_t ones = 0;
+        for (uint64_t word : a) {
+            ones += bitset<64>(word).count();
+        }
+        auto check = [&](auto apply_and, auto apply_and_not, auto not_words, auto pop_count) {
+            vector<uint64_t> dst = a;
+            apply_and(dst.data(), b.data(), dst.size());
+            for (size_t i = 0; i < a.size(); ++i) {
+                assert(dst[i] == (a[i] & b[i]));
+            }
+            dst = a;
+            apply_and_not(dst.data(), b.data(), dst.size());
+            not_words(dst.data(), dst.size());
+            for (size_t i = 0; i < a.size(); ++i) {
+                assert(dst[i] == ~(a[i] & ~b[i]));
+            }
+            assert(pop_count(a.data(), a.size()) == ones);
+        };
+        using simd::BitOp;
+        check(simd::scalar::ApplyBitOp<BitOp::kAnd>, simd::scalar::ApplyBitOp<BitOp::kAndNot>, simd::scalar::NotWords,
+              simd::scalar::PopCount);
+#ifdef SIMPLE_VECTOR_X86_SIMD
+        if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+            check(simd::sse42::ApplyBitOp<BitOp::kAnd>, simd::sse42::ApplyBitOp<BitOp::kAndNot>, simd::sse42::NotWords,
+                  simd::sse42::PopCount);
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            check(simd::avx2::ApplyBitOp<BitOp::kAnd>, simd::avx2::ApplyBitOp<BitOp::kAndNot>, simd::avx2::NotWords,
+                  simd::avx2::PopCount);
+        }
+#endif
+    }
+
+    // Распаковка полос: все ширины, обе кодировки
+    {
+        mt19937_64 gen(9);
+        const size_t rows = 64;
+        const uint64_t base[simd::kPackLanes] = {5, 1ull << 40, ~0ull, 0};
+        for (unsigned width = 1; width < 64; ++width) {
+            const uint64_t mask = (uint64_t(1) << width) - 1;
+            vector<uint64_t> values(rows * simd::kPackLanes);
+            vector<uint64_t> packed(width * simd::kPackLanes);
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = gen() & mask;
+                const size_t lane = i % simd::kPackLanes;
+                const size_t bit = i / simd::kPackLanes * width;
+                packed[bit / 64 * simd::kPackLanes + lane] |= values[i] << bit % 64;
+                if (bit % 64 + width > 64) {
+                    packed[(bit / 64 + 1) * simd::kPackLanes + lane] |= values[i] >> (64 - bit % 64);
+                }
+            }
+            auto check = [&](auto unpack) {
+                for (bool delta : {false, true}) {
+                    vector<uint64_t> out(values.size());
+                    unpack(packed.data(), width, rows, base, delta, out.data());
+                    uint64_t acc[simd::kPackLanes];
+                    copy(base, base + simd::kPackLanes, acc);
+                    for (size_t i = 0; i < values.size(); ++i) {
+                        const size_t lane = i % simd::kPackLanes;
+                        acc[lane] = (delta ? acc[lane] : base[lane]) + values[i];
+                        assert(out[i] == acc[lane]);
+                    }
+                }
+            };
+            check(simd::scalar::UnpackLanes);
+#ifdef SIMPLE_VECTOR_X86_SIMD
+            if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+                check(simd::sse42::UnpackLanes);
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+                check(simd::avx2::UnpackLanes);
+            }
+#endif
+        }
+    }
+
+    // Операторы сравнения
+    {
+        SimpleVector<int> a(100, 5);
+        SimpleVector<int> b(a);
+        assert(a == b && !(a != b) && !(a < b) && !(a > b) && a <= b && a >= b);
+        b[73] = 6;
+        assert(a != b && a < b && !(a > b) && a <= b && !(a >= b));
+        assert(b > a && b >= a && !(b < a) && !(b <= a));
+        b.PopBack();
+        assert(b > a);
+        b[73] = 5;
+        assert(b < a && a > b);
+
+        SimpleVector<uint8_t> low{1, 2, 200};
+        SimpleVector<uint8_t> high{1, 2, 201};
+        assert(low < high && high > low);
+        SimpleVector<int8_t> negative{1, 2, -1};
+        SimpleVector<int8_t> positive{1, 2, 1};
+        assert(negative < positive);
+
+        const double nan = numeric_limits<double>::quiet_NaN();
+        SimpleVector<double> x{1.0, nan, 2.0};
+        SimpleVector<double> y{1.0, nan, 3.0};
+        assert(x != x && x < y && y > x);
+
+        SimpleVector<string> words{"a"s, "b"s};
+        SimpleVector<string> more_words{"a"s, "b"s, "c"s};
+        assert(words < more_words && more_words > words && !(words > words) && words >= words);
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+        assert((a <=> b) > 0 && (words <=> more_words) < 0 && (a <=> a) == 0);
+#endif
+
+        SmallSimpleVector<int, 4> small_a{1, 2, 3};
+        SmallSimpleVector<int, 4> small_b{1, 2, 4};
+        assert(small_a < small_b && small_b > small_a && small_a != small_b);
+    }
+
+    // Поиск по вектору
+    {
+        SimpleVector<int> v(1000);
+        iota(v.begin(), v.end(), -500);
+        v[900] = 7;
+        assert(Find(v, 7) == v.begin() + 507);
+        assert(Find(v, 100000) == v.end());
+        assert(Count(v, 7) == 2);
+        assert(*MinElement(v) == -500 && MinElement(v) == v.begin());
+        assert(*MaxElement(v) == 499 && MaxElement(v) == v.begin() + 999);
+        SimpleVector<int> empty;
+        assert(MinElement(empty) == empty.end() && MaxElement(empty) == empty.end());
+
+        SimpleVector<string> words{"b"s, "a"s, "c"s, "a"s};
+        assert(Find(words, "a"s) == words.begin() + 1 && Count(words, "a"s) == 2);
+        assert(*MinElement(words) == "a"s && *MaxElement(words) == "c"s);
+    }
+    cout << "Done!"s << endl;
+}
+
+template <template <typename> class Alloc>
+void RunScenarios() {
+    TestTemporaryObjConstructor<Alloc>();
+    TestTemporaryObjOperator<Alloc>();
+    TestNamedMoveConstructor<Alloc>();
+    TestNamedMoveOperator<Alloc>();
+    TestNoncopiableMoveConstructor<Alloc>();
+    TestNoncopiablePushBack<Alloc>();
+    TestNoncopiableInsert<Alloc>();
+    TestNoncopiableErase<Alloc>();
+    TestUninitializedCapacity<Alloc>();
+}
+
 int main() {
-    TestTemporaryObjConstructor();
-    TestTemporaryObjOperator();
-    TestNamedMoveConstructor();
-    TestNamedMoveOperator();
-    TestNoncopiableMoveConstructor();
-    TestNoncopiablePushBack();
-    TestNoncopiableInsert();
-    TestNoncopiableErase();
+    RunScenarios<allocator>();
+
+    RunScenarios<CountingAllocator>();
+    assert(default_allocation_stats.allocations > 0);
+    assert(default_allocation_stats.allocations == default_allocation_stats.deallocations);
+    assert(default_allocation_stats.bytes_in_use == 0);
+
+    TestEmplace();
+    TestEmplaceStrongGuarantee();
+    TestTriviallyRelocatable();
+    TestGrowthPolicy();
+    TestRangeOperations();
+    TestSmallSimpleVector();
+    TestVectorStats();
+    TestParallelAlgorithms();
+    TestStatefulAllocator();
+    TestPmrSimpleVector();
+    TestSimdKernels();
+    TestConcurrentSimpleVector();
+    TestMappedSimpleVector();
+    TestSerialization();
+    TestSoASimpleVector();
+    TestPersistentSimpleVector();
+    TestLargePageAllocator();
+    TestCircularSimpleVector();
+    TestBitVector();
+    TestPackedIntVector();
+    TestRecyclingAllocator();
+    TestVectorExpressions();
+    TestAdoptAndRelease();
+    TestSimpleVectorView();
     return 0;
 }
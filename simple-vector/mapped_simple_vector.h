@@ -0,0 +1,410 @@
+#pragma once
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "growth_policy.h"
+
+// Вектор тривиально копируемых элементов, хранящихся в файле, отображённом в память.
+// Файл начинается с заголовка MappedVectorHeader, за ним идут элементы; размер файла
+// задаёт вместимость. Открытие файла не читает данные: страницы подгружаются
+// операционной системой при первом обращении, поэтому вектор может быть больше
+// оперативной памяти, а повторное открытие занимает миллисекунды.
+// Рост - ftruncate и mremap (на Linux без копирования страниц).
+// При перераспределении указатели и ссылки на элементы, как и у SimpleVector, становятся недействительными.
+// Вектор не потокобезопасен; один файл нельзя одновременно открывать на запись из нескольких объектов
+
+// Заголовок файла. Занимает 64 байта, чтобы элементы начинались с выровненного адреса
+struct MappedVectorHeader {
+    static constexpr char kMagic[8] = {'S', 'V', 'M', 'A', 'P', '\0', '\0', '\0'};
+    static constexpr std::uint32_t kVersion = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t element_size;
+    std::uint64_t count;
+    unsigned char reserved[40];
+};
+static_assert(sizeof(MappedVectorHeader) == 64);
+
+// Подсказки ядру о характере доступа к элементам (madvise)
+enum class MappedAccess {
+    kNormal,
+    kSequential,
+    kRandom,
+    kWillNeed,
+};
+
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+class MappedSimpleVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedSimpleVector stores elements as raw bytes");
+    static_assert(alignof(Type) <= sizeof(MappedVectorHeader), "elements must fit the header alignment");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    enum class Mode {
+        kReadOnly,
+        kReadWrite,
+    };
+
+    // Открывает файл path. В режиме kReadWrite несуществующий файл создаётся пустым.
+    // Выбрасывает std::system_error при ошибках ввода-вывода и std::runtime_error,
+    // если файл не является вектором этого типа
+    static MappedSimpleVector Open(const std::string& path, Mode mode = Mode::kReadWrite) {
+        const bool read_only = mode == Mode::kReadOnly;
+        const int fd = ::open(path.c_str(), read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        MappedSimpleVector result(fd, read_only);
+        result.MapExisting(path);
+        return result;
+    }
+
+    // Создаёт пустой вектор в файле path, затирая прежнее содержимое
+    static MappedSimpleVector Create(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        MappedSimpleVector result(fd, false);
+        result.MapExisting(path);
+        return result;
+    }
+
+    MappedSimpleVector(const MappedSimpleVector&) = delete;
+    MappedSimpleVector& operator=(const MappedSimpleVector&) = delete;
+
+    MappedSimpleVector(MappedSimpleVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , read_only_(other.read_only_)
+        , base_(std::exchange(other.base_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    MappedSimpleVector& operator=(MappedSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            read_only_ = rhs.read_only_;
+            base_ = std::exchange(rhs.base_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    // Снимает отображение и закрывает файл. Данные сбрасываются на диск ядром;
+    // для немедленной записи нужен Flush
+    ~MappedSimpleVector() {
+        Close();
+    }
+
+    bool IsReadOnly() const noexcept {
+        return read_only_;
+    }
+
+    size_t GetSize() const noexcept {
+        return base_ ? Header().count : 0;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // В режиме kReadOnly память доступна только для чтения: запись через
+    // неконстантную ссылку приведёт к SIGSEGV
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Not-element");
+        }
+        return Data()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Not-element");
+        }
+        return Data()[index];
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Изменяет вместимость файла так, чтобы в нём помещалось не меньше new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Remap(new_capacity);
+        }
+    }
+
+    // Обнуляет размер. Место в файле сохраняется
+    void Clear() {
+        CheckWritable();
+        SetSize(0);
+    }
+
+    // Изменяет размер; новые элементы заполняются значением по умолчанию
+    void Resize(size_t new_size) {
+        CheckWritable();
+        const size_t size = GetSize();
+        if (new_size > capacity_) {
+            Remap(GrownCapacity(new_size));
+        }
+        if (new_size > size) {
+            std::fill(Data() + size, Data() + new_size, Type{});
+        }
+        SetSize(new_size);
+    }
+
+    void PushBack(const Type& item) {
+        CheckWritable();
+        const Type value = item;  // item может лежать в отображении, которое переедет при росте
+        const size_t size = GetSize();
+        if (size == capacity_) {
+            Remap(GrownCapacity(size + 1));
+        }
+        Data()[size] = value;
+        SetSize(size + 1);
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty() && !read_only_);
+        SetSize(GetSize() - 1);
+    }
+
+    // Вставляет value в позицию pos и возвращает итератор на вставленный элемент
+    Iterator Insert(ConstIterator pos, const Type& item) {
+        CheckWritable();
+        assert(cbegin() <= pos && cend() >= pos);
+        const Type value = item;
+        const size_t index = pos - cbegin();
+        const size_t size = GetSize();
+        if (size == capacity_) {
+            Remap(GrownCapacity(size + 1));
+        }
+        std::memmove(Data() + index + 1, Data() + index, (size - index) * sizeof(Type));
+        Data()[index] = value;
+        SetSize(size + 1);
+        return Data() + index;
+    }
+
+    // Удаляет элемент в позиции pos и возвращает итератор на следующий за ним
+    Iterator Erase(ConstIterator pos) {
+        CheckWritable();
+        assert(cbegin() <= pos && cend() > pos);
+        const size_t index = pos - cbegin();
+        const size_t size = GetSize();
+        std::memmove(Data() + index, Data() + index + 1, (size - index - 1) * sizeof(Type));
+        SetSize(size - 1);
+        return Data() + index;
+    }
+
+    // Уменьшает файл до размера, занятого элементами
+    void ShrinkToFit() {
+        CheckWritable();
+        if (GetSize() < capacity_) {
+            Remap(GetSize());
+        }
+    }
+
+    // Синхронно записывает изменённые страницы на диск
+    void Flush() {
+        if (!read_only_ && ::msync(base_, mapped_bytes_, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+    // Сообщает ядру, как будут читаться элементы: kSequential включает агрессивное
+    // упреждающее чтение и раннее вытеснение прочитанных страниц, kRandom отключает
+    // упреждающее чтение, kWillNeed запускает подгрузку всего файла в фоне.
+    // Подсказка действует на текущее отображение и сбрасывается при перераспределении
+    void Advise(MappedAccess access) {
+        static constexpr int kAdvice[] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED};
+        if (::madvise(base_, mapped_bytes_, kAdvice[static_cast<int>(access)]) != 0) {
+            throw std::system_error(errno, std::generic_category(), "madvise");
+        }
+    }
+
+private:
+    static constexpr size_t kHeaderSize = sizeof(MappedVectorHeader);
+
+    MappedSimpleVector(int fd, bool read_only) noexcept
+        : fd_(fd)
+        , read_only_(read_only) {
+    }
+
+    MappedVectorHeader& Header() const noexcept {
+        return *static_cast<MappedVectorHeader*>(base_);
+    }
+
+    Type* Data() const noexcept {
+        return reinterpret_cast<Type*>(static_cast<unsigned char*>(base_) + kHeaderSize);
+    }
+
+    void SetSize(size_t size) noexcept {
+        Header().count = size;
+    }
+
+    void CheckWritable() const {
+        if (read_only_) {
+            throw std::logic_error("MappedSimpleVector is opened read-only");
+        }
+    }
+
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::Next(capacity_, sizeof(Type)), required);
+    }
+
+    // Отображает открытый файл целиком; пустой файл получает новый заголовок
+    void MapExisting(const std::string& path) {
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fstat " + path);
+        }
+        size_t file_size = static_cast<size_t>(st.st_size);
+        const bool fresh = file_size == 0;
+        if (fresh) {
+            if (read_only_) {
+                throw std::runtime_error(path + " is empty");
+            }
+            file_size = kHeaderSize;
+            Truncate(file_size);
+        } else if (file_size < kHeaderSize) {
+            throw std::runtime_error(path + " is too small for a MappedSimpleVector header");
+        }
+        const int protection = read_only_ ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void* base = ::mmap(nullptr, file_size, protection, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap " + path);
+        }
+        base_ = base;
+        mapped_bytes_ = file_size;
+        capacity_ = (file_size - kHeaderSize) / sizeof(Type);
+        MappedVectorHeader& header = Header();
+        if (fresh) {
+            std::memcpy(header.magic, MappedVectorHeader::kMagic, sizeof(header.magic));
+            header.version = MappedVectorHeader::kVersion;
+            header.element_size = sizeof(Type);
+            header.count = 0;
+            return;
+        }
+        if (std::memcmp(header.magic, MappedVectorHeader::kMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error(path + " is not a MappedSimpleVector file");
+        }
+        if (header.version != MappedVectorHeader::kVersion) {
+            throw std::runtime_error(path + " has unsupported version " + std::to_string(header.version));
+        }
+        if (header.element_size != sizeof(Type)) {
+            throw std::runtime_error(path + " stores " + std::to_string(header.element_size) + "-byte elements, expected "
+                                     + std::to_string(sizeof(Type)));
+        }
+        if (header.count > capacity_) {
+            throw std::runtime_error(path + " is truncated");
+        }
+    }
+
+    void Truncate(size_t bytes) {
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "ftruncate");
+        }
+    }
+
+    // Меняет размер файла и отображения под new_capacity элементов.
+    // На Linux mremap переносит отображение без копирования страниц
+    void Remap(size_t new_capacity) {
+        CheckWritable();
+        const size_t new_bytes = kHeaderSize + new_capacity * sizeof(Type);
+        if (new_bytes > mapped_bytes_) {
+            Truncate(new_bytes);
+        }
+#ifdef __linux__
+        void* base = ::mremap(base_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+        if (base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mremap");
+        }
+#else
+        void* base = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        ::munmap(base_, mapped_bytes_);
+#endif
+        // Старого отображения уже нет, поэтому состояние обновляется до усечения файла
+        const bool shrink = new_bytes < mapped_bytes_;
+        base_ = base;
+        mapped_bytes_ = new_bytes;
+        capacity_ = new_capacity;
+        if (shrink) {
+            // Хвост файла за отображением не используется: если ftruncate не смог
+            // его отрезать, файл просто останется длиннее
+            static_cast<void>(::ftruncate(fd_, static_cast<off_t>(new_bytes)));
+        }
+    }
+
+    void Close() noexcept {
+        if (base_ != nullptr) {
+            ::munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_ = -1;
+    bool read_only_ = false;
+    void* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,481 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "simd.h"
+#include "simple_vector.h"
+
+// Сжатый вектор целых чисел. Значения хранятся блоками по kBlockSize, каждый блок
+// упакован минимальным числом битов на значение в одной из двух кодировок:
+// - kFrameOfReference: значение минус минимум блока;
+// - kDelta: разность с предыдущим значением той же полосы, если полосы блока не убывают.
+// Значение i блока лежит в полосе i % kLanes, полосы упакованы независимо, поэтому
+// распаковка блока идёт векторами (simd::UnpackLanes). Последний неполный блок
+// хранится несжатым и запечатывается, когда следом добавляется новое значение.
+// Доступ по индексу в kFrameOfReference - O(1), в kDelta - сумма не больше
+// kBlockSize / kLanes разностей. Ссылок на элементы нет: значения отдаются копией
+template <typename Type>
+class PackedIntVector {
+    static_assert(std::is_integral_v<Type> && !std::is_same_v<Type, bool>);
+
+    using Word = std::uint64_t;
+
+public:
+    static constexpr size_t kBlockSize = 256;
+    static constexpr size_t kLanes = simd::kPackLanes;
+
+    enum class Encoding : std::uint8_t {
+        kFrameOfReference,
+        kDelta,
+    };
+
+    // Итератор распаковывает блок целиком в собственный буфер и отдаёт значения из него,
+    // поэтому весит kBlockSize слов. При последовательном обходе каждый блок
+    // распаковывается один раз
+    class ConstIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Type;
+
+        ConstIterator() = default;
+
+        ConstIterator(const PackedIntVector* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        Type operator*() const noexcept {
+            const size_t offset = index_ - cached_first_;
+            if (offset < cached_count_) {
+                return static_cast<Type>(buffer_[offset]);
+            }
+            Load();
+            return static_cast<Type>(buffer_[index_ - cached_first_]);
+        }
+
+        Type operator[](difference_type n) const noexcept {
+            return (*owner_)[index_ + n];
+        }
+
+        ConstIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            ConstIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        ConstIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        ConstIterator operator--(int) noexcept {
+            ConstIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        ConstIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend ConstIterator operator+(ConstIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend ConstIterator operator+(difference_type n, ConstIterator it) noexcept {
+            return it += n;
+        }
+
+        friend ConstIterator operator-(ConstIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        // Распаковывает в буфер блок с текущим значением; несжатый хвост копируется как есть
+        void Load() const noexcept {
+            const size_t block = index_ / kBlockSize;
+            cached_first_ = block * kBlockSize;
+            if (block < owner_->blocks_.GetSize()) {
+                owner_->DecodeBlock(block, buffer_);
+                cached_count_ = kBlockSize;
+            } else {
+                cached_count_ = owner_->tail_.GetSize();
+                std::transform(owner_->tail_.begin(), owner_->tail_.end(), buffer_, &ToWord);
+            }
+        }
+
+        const PackedIntVector* owner_ = nullptr;
+        size_t index_ = 0;
+        mutable size_t cached_first_ = 0;
+        mutable size_t cached_count_ = 0;
+        mutable Word buffer_[kBlockSize] = {};
+    };
+
+    PackedIntVector() noexcept = default;
+
+    explicit PackedIntVector(size_t size, Type value = Type()) {
+        Resize(size, value);
+    }
+
+    PackedIntVector(std::initializer_list<Type> init) {
+        Reserve(init.size());
+        for (Type value : init) {
+            PushBack(value);
+        }
+    }
+
+    // Резервирует место под capacity значений
+    PackedIntVector(ReserveProxyObj Rpo) {
+        Reserve(Rpo.GetRes());
+    }
+
+    size_t GetSize() const noexcept {
+        return GetSealedSize() + tail_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    Type operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        const size_t block = index / kBlockSize;
+        if (block >= blocks_.GetSize()) {
+            return tail_[index - GetSealedSize()];
+        }
+        return static_cast<Type>(DecodeValue(blocks_[block], index % kBlockSize));
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Not-element");
+        }
+        return (*this)[index];
+    }
+
+    Type Back() const noexcept {
+        return (*this)[GetSize() - 1];
+    }
+
+    ConstIterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    ConstIterator end() const noexcept {
+        return {this, GetSize()};
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Добавляет значение; при исключении вектор не меняется
+    void PushBack(Type value) {
+        if (tail_.GetSize() == kBlockSize) {
+            SealTail();
+        }
+        tail_.PushBack(value);
+    }
+
+    void PopBack() {
+        assert(!IsEmpty());
+        if (tail_.IsEmpty()) {
+            UnsealLastBlock();
+        }
+        tail_.PopBack();
+    }
+
+    // Изменяет размер; новые значения равны value
+    void Resize(size_t new_size, Type value = Type()) {
+        const size_t sealed_size = GetSealedSize();
+        if (new_size < sealed_size) {
+            // Место под распакованный блок выделяется до того, как отброшены лишние
+            tail_.Reserve(kBlockSize);
+            const size_t block = new_size / kBlockSize;
+            while (blocks_.GetSize() > block + 1) {
+                words_.Resize(blocks_[blocks_.GetSize() - 1].offset);
+                blocks_.PopBack();
+            }
+            tail_.Clear();
+            UnsealLastBlock();
+        }
+        if (new_size <= GetSize()) {
+            tail_.Resize(new_size - GetSealedSize());
+            return;
+        }
+        Reserve(new_size);
+        while (GetSize() < new_size) {
+            PushBack(value);
+        }
+    }
+
+    // Резервирует место под служебные данные capacity значений и несжатый хвост.
+    // Объём упакованных данных заранее не известен
+    void Reserve(size_t capacity) {
+        blocks_.Reserve(capacity / kBlockSize + 1);
+        tail_.Reserve(std::min(capacity, kBlockSize));
+    }
+
+    // Отдаёт резерв упакованных данных и служебных структур
+    void ShrinkToFit() {
+        blocks_.ShrinkToFit();
+        words_.ShrinkToFit();
+        tail_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        blocks_.Clear();
+        words_.Clear();
+        tail_.Clear();
+    }
+
+    void swap(PackedIntVector& other) noexcept {
+        blocks_.swap(other.blocks_);
+        words_.swap(other.words_);
+        tail_.swap(other.tail_);
+    }
+
+    // Распаковывает count значений, начиная с first, в out
+    void Decode(size_t first, size_t count, Type* out) const {
+        assert(first + count <= GetSize());
+        Word buffer[kBlockSize];
+        while (count > 0) {
+            const size_t block = first / kBlockSize;
+            const size_t offset = first % kBlockSize;
+            const size_t chunk = std::min(count, kBlockSize - offset);
+            if (block >= blocks_.GetSize()) {
+                std::copy_n(tail_.begin() + (first - GetSealedSize()), chunk, out);
+            } else {
+                DecodeBlock(block, buffer);
+                std::transform(buffer + offset, buffer + offset + chunk, out, [](Word word) {
+                    return static_cast<Type>(word);
+                });
+            }
+            first += chunk;
+            count -= chunk;
+            out += chunk;
+        }
+    }
+
+    // Число запечатанных (сжатых) блоков
+    size_t GetBlockCount() const noexcept {
+        return blocks_.GetSize();
+    }
+
+    Encoding GetBlockEncoding(size_t block) const noexcept {
+        return blocks_[block].encoding;
+    }
+
+    // Битов на значение в блоке
+    unsigned GetBlockWidth(size_t block) const noexcept {
+        return blocks_[block].width;
+    }
+
+    // Занятая память в байтах вместе с резервом
+    size_t GetMemoryUsage() const noexcept {
+        return blocks_.GetCapacity() * sizeof(Block) + words_.GetCapacity() * sizeof(Word)
+               + tail_.GetCapacity() * sizeof(Type);
+    }
+
+    friend bool operator==(const PackedIntVector& lhs, const PackedIntVector& rhs) {
+        return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const PackedIntVector& lhs, const PackedIntVector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    static constexpr size_t kRows = kBlockSize / kLanes;
+
+    // Блок занимает ровно width * kLanes слов, начиная с offset
+    struct Block {
+        size_t offset;
+        Word base[kLanes];
+        std::uint8_t width;
+        Encoding encoding;
+    };
+
+    // Знаковые значения расширяются знаком, поэтому разность двух значений
+    // в словах совпадает с их настоящей неотрицательной разностью
+    static Word ToWord(Type value) noexcept {
+        return static_cast<Word>(value);
+    }
+
+    static unsigned BitWidth(Word value) noexcept {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    size_t GetSealedSize() const noexcept {
+        return blocks_.GetSize() * kBlockSize;
+    }
+
+    // Значение полосы lane в строке row без базы
+    static Word Extract(const Word* words, unsigned width, size_t row, size_t lane) noexcept {
+        if (width == 0) {
+            return 0;
+        }
+        const size_t bit = row * width;
+        const size_t word = bit / 64;
+        const unsigned shift = bit % 64;
+        Word value = words[word * kLanes + lane] >> shift;
+        if (shift + width > 64) {
+            value |= words[(word + 1) * kLanes + lane] << (64 - shift);
+        }
+        return width == 64 ? value : value & ((Word(1) << width) - 1);
+    }
+
+    Word DecodeValue(const Block& block, size_t index) const noexcept {
+        const Word* words = words_.begin() + block.offset;
+        const size_t lane = index % kLanes;
+        const size_t row = index / kLanes;
+        if (block.encoding == Encoding::kFrameOfReference) {
+            return block.base[lane] + Extract(words, block.width, row, lane);
+        }
+        Word value = block.base[lane];
+        for (size_t r = 1; r <= row; ++r) {
+            value += Extract(words, block.width, r, lane);
+        }
+        return value;
+    }
+
+    void DecodeBlock(size_t index, Word* out) const noexcept {
+        const Block& block = blocks_[index];
+        const Word* words = words_.begin() + block.offset;
+        const bool delta = block.encoding == Encoding::kDelta;
+        if (block.width > 0 && block.width < 64) {
+            simd::UnpackLanes(words, block.width, kRows, block.base, delta, out);
+            return;
+        }
+        // Крайние ширины: все разности нулевые или значения занимают слово целиком
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            Word acc = block.base[lane];
+            for (size_t row = 0; row < kRows; ++row) {
+                const Word value = Extract(words, block.width, row, lane);
+                acc = (delta ? acc : block.base[lane]) + value;
+                out[row * kLanes + lane] = acc;
+            }
+        }
+    }
+
+    // Сжимает полный хвост в новый блок; при исключении ничего не меняется
+    void SealTail() {
+        const Type* values = tail_.begin();
+        Block block{};
+        const auto [min_it, max_it] = std::minmax_element(values, values + kBlockSize);
+        const unsigned reference_width = BitWidth(ToWord(*max_it) - ToWord(*min_it));
+        bool lanes_sorted = true;
+        Word max_delta = 0;
+        for (size_t i = kLanes; i < kBlockSize && lanes_sorted; ++i) {
+            lanes_sorted = values[i - kLanes] <= values[i];
+            max_delta = std::max(max_delta, ToWord(values[i]) - ToWord(values[i - kLanes]));
+        }
+        if (lanes_sorted && BitWidth(max_delta) < reference_width) {
+            block.encoding = Encoding::kDelta;
+            block.width = BitWidth(max_delta);
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                block.base[lane] = ToWord(values[lane]);
+            }
+        } else {
+            block.encoding = Encoding::kFrameOfReference;
+            block.width = reference_width;
+            std::fill(block.base, block.base + kLanes, ToWord(*min_it));
+        }
+
+        // Новые слова создаются нулевыми, значения добавляются в них через |=
+        block.offset = words_.GetSize();
+        words_.Resize(block.offset + block.width * kLanes);
+        try {
+            blocks_.PushBack(block);
+        } catch (...) {
+            words_.Resize(block.offset);
+            throw;
+        }
+
+        Word* words = words_.begin() + block.offset;
+        for (size_t i = 0; i < kBlockSize && block.width > 0; ++i) {
+            const size_t lane = i % kLanes;
+            const size_t row = i / kLanes;
+            const Word value = block.encoding == Encoding::kDelta
+                                   ? (row == 0 ? 0 : ToWord(values[i]) - ToWord(values[i - kLanes]))
+                                   : ToWord(values[i]) - block.base[lane];
+            const size_t bit = row * block.width;
+            const size_t word = bit / 64;
+            const unsigned shift = bit % 64;
+            words[word * kLanes + lane] |= value << shift;
+            if (shift + block.width > 64) {
+                words[(word + 1) * kLanes + lane] |= value >> (64 - shift);
+            }
+        }
+        tail_.Clear();
+    }
+
+    // Распаковывает последний блок обратно в пустой хвост
+    void UnsealLastBlock() {
+        assert(tail_.IsEmpty() && !blocks_.IsEmpty());
+        Word buffer[kBlockSize];
+        DecodeBlock(blocks_.GetSize() - 1, buffer);
+        tail_.Resize(kBlockSize);
+        std::transform(buffer, buffer + kBlockSize, tail_.begin(), [](Word word) {
+            return static_cast<Type>(word);
+        });
+        words_.Resize(blocks_[blocks_.GetSize() - 1].offset);
+        blocks_.PopBack();
+    }
+
+    SimpleVector<Block> blocks_;
+    SimpleVector<Word> words_;
+    SimpleVector<Type> tail_;
+};
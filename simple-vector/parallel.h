@@ -0,0 +1,460 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "simple_vector.h"
+
+// Параллельные алгоритмы над SimpleVector.
+// Вектор делится на куски, границы которых выровнены по кеш-линиям, чтобы потоки
+// не писали в одну линию, и куски выполняются в пуле потоков с перехватом задач.
+// Вызывающий поток тоже выполняет куски, пока ждёт остальные.
+// Векторы короче ParallelOptions::serial_threshold обрабатываются в одном потоке
+
+// Пул потоков с собственной очередью у каждого рабочего потока.
+// Поток берёт задачи из конца своей очереди, а когда она пуста,
+// перехватывает задачи из начала чужих очередей
+class ThreadPool {
+public:
+    // Рабочих потоков на один меньше, чем ядер: вызывающий поток тоже выполняет задачи
+    static size_t DefaultThreadCount() noexcept {
+        const size_t cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 0;
+    }
+
+    explicit ThreadPool(size_t thread_count = DefaultThreadCount()) {
+        for (size_t i = 0; i < std::max<size_t>(thread_count, 1); ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 0; i < thread_count; ++i) {
+            workers_.emplace_back([this, i] {
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(wake_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t GetThreadCount() const noexcept {
+        return workers_.size();
+    }
+
+    // Ставит задачу в очередь. Рабочий поток пула кладёт её в свою очередь,
+    // остальные потоки распределяют задачи по очередям по кругу
+    void Submit(std::function<void()> task) {
+        const size_t index = current_pool_ == this
+            ? current_index_
+            : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard guard(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard guard(wake_mutex_);
+            ++pending_;
+        }
+        wake_.notify_one();
+    }
+
+    // Выполняет в вызывающем потоке одну ожидающую задачу, если она есть
+    bool TryRunOne() {
+        std::function<void()> task;
+        if (!Steal(queues_.size(), task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool PopOwn(size_t index, std::function<void()>& task) {
+        Queue& queue = *queues_[index];
+        std::lock_guard guard(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        TakePending();
+        return true;
+    }
+
+    // Забирает самую старую задачу из чужой очереди, начиная с соседа thief
+    bool Steal(size_t thief, std::function<void()>& task) {
+        for (size_t i = 1; i <= queues_.size(); ++i) {
+            Queue& queue = *queues_[(thief + i) % queues_.size()];
+            std::lock_guard guard(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                TakePending();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TakePending() {
+        std::lock_guard guard(wake_mutex_);
+        --pending_;
+    }
+
+    void WorkerLoop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+        std::function<void()> task;
+        while (true) {
+            if (PopOwn(index, task) || Steal(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock lock(wake_mutex_);
+            wake_.wait(lock, [this] {
+                return stop_ || pending_ > 0;
+            });
+            if (stop_ && pending_ == 0) {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local ThreadPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    size_t pending_ = 0;
+    bool stop_ = false;
+    std::atomic<size_t> next_queue_{0};
+};
+
+// Пул, которым параллельные алгоритмы пользуются по умолчанию
+inline ThreadPool& DefaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+struct ParallelOptions {
+    // Пул потоков; nullptr означает DefaultThreadPool()
+    ThreadPool* pool = nullptr;
+    // Векторы короче этого порога обрабатываются в вызывающем потоке
+    size_t serial_threshold = size_t(1) << 15;
+    // Сколько кусков приходится на поток: больше кусков - лучше балансировка
+    size_t chunks_per_thread = 4;
+};
+
+namespace parallel_detail {
+
+constexpr size_t kCacheLine = 64;
+
+inline ThreadPool& PoolOf(const ParallelOptions& options) {
+    return options.pool ? *options.pool : DefaultThreadPool();
+}
+
+// Выполняет fn(i) для i из [0, task_count) в пуле и в вызывающем потоке и ждёт завершения всех.
+// Первое возникшее исключение пробрасывается после завершения остальных задач.
+// Общее состояние живёт в стеке вызывающего, поэтому счётчик уменьшается и проверяется
+// только под mutex: вызывающий не может вернуться, пока последняя задача его не отпустила
+template <typename Fn>
+void RunTasks(ThreadPool& pool, size_t task_count, Fn&& fn) {
+    if (task_count == 0) {
+        return;
+    }
+    size_t remaining = task_count;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+    auto run = [&](size_t i) {
+        std::exception_ptr task_error;
+        try {
+            fn(i);
+        } catch (...) {
+            task_error = std::current_exception();
+        }
+        std::lock_guard guard(mutex);
+        if (task_error && !error) {
+            error = std::move(task_error);
+        }
+        if (--remaining == 0) {
+            done.notify_all();
+        }
+    };
+
+    // Если очередь пула не приняла задачу (например, из-за нехватки памяти), уже отправленные
+    // задачи по-прежнему ссылаются на run, поэтому оставшиеся куски выполняются здесь
+    size_t submitted = 1;
+    try {
+        for (; submitted < task_count; ++submitted) {
+            pool.Submit([&run, i = submitted] {
+                run(i);
+            });
+        }
+    } catch (...) {
+    }
+    run(0);
+    for (size_t i = submitted; i < task_count; ++i) {
+        run(i);
+    }
+    // Пока остаются задачи, вызывающий поток помогает пулу, а затем ждёт остальных
+    for (;;) {
+        {
+            std::lock_guard guard(mutex);
+            if (remaining == 0) {
+                break;
+            }
+        }
+        if (!pool.TryRunOne()) {
+            break;
+        }
+    }
+    std::unique_lock lock(mutex);
+    done.wait(lock, [&] {
+        return remaining == 0;
+    });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Делит count элементов массива, начинающегося по адресу base, на куски.
+// Возвращает границы кусков [bounds[i], bounds[i + 1]); все внутренние границы
+// приходятся на начало кеш-линии, если размер элемента делит её размер
+template <typename Type>
+std::vector<size_t> ChunkBounds(const Type* base, size_t count, size_t chunk_count) {
+    std::vector<size_t> bounds{0};
+    if (count == 0) {
+        return {0, 0};
+    }
+    size_t line = 1;
+    size_t head = 0;
+    if (kCacheLine % sizeof(Type) == 0) {
+        line = kCacheLine / sizeof(Type);
+        const size_t misalignment = reinterpret_cast<std::uintptr_t>(base) % kCacheLine;
+        if (misalignment % sizeof(Type) == 0) {
+            head = (kCacheLine - misalignment) % kCacheLine / sizeof(Type);
+        }
+    }
+    size_t chunk = (count + chunk_count - 1) / chunk_count;
+    chunk = (chunk + line - 1) / line * line;
+    for (size_t bound = head + chunk; bound < count; bound += chunk) {
+        bounds.push_back(bound);
+    }
+    bounds.push_back(count);
+    return bounds;
+}
+
+// Выполняет body(begin, end) для кусков [0, count) массива base
+template <typename Type, typename Body>
+void ForEachChunk(const Type* base, size_t count, const ParallelOptions& options, Body&& body) {
+    ThreadPool& pool = PoolOf(options);
+    if (count < options.serial_threshold || pool.GetThreadCount() == 0) {
+        if (count != 0) {
+            body(size_t(0), count);
+        }
+        return;
+    }
+    const std::vector<size_t> bounds =
+        ChunkBounds(base, count, (pool.GetThreadCount() + 1) * std::max<size_t>(options.chunks_per_thread, 1));
+    RunTasks(pool, bounds.size() - 1, [&](size_t i) {
+        body(bounds[i], bounds[i + 1]);
+    });
+}
+
+// Добавляет в конец вектора count элементов, создавая их кусками в нескольких потоках
+// функцией construct(Type* first, size_t count). Если какой-то кусок не удалось создать,
+// уже созданные куски разрушаются, а исключение пробрасывается
+template <typename Vector, typename Construct>
+void ParallelAppend(Vector& v, size_t count, const ParallelOptions& options, Construct construct) {
+    v.AppendWith(count, [&](auto* first, size_t n) {
+        std::mutex mutex;
+        std::vector<std::pair<size_t, size_t>> constructed;
+        try {
+            ForEachChunk(first, n, options, [&](size_t b, size_t e) {
+                construct(first + b, e - b);
+                std::lock_guard guard(mutex);
+                constructed.emplace_back(b, e);
+            });
+        } catch (...) {
+            for (auto [b, e] : constructed) {
+                std::destroy(first + b, first + e);
+            }
+            throw;
+        }
+    });
+}
+
+}  // namespace parallel_detail
+
+// Создаёт вектор из size элементов, инициализированных значением по умолчанию.
+// Каждый кусок памяти первым заполняет поток, который будет обрабатывать его
+// в остальных параллельных алгоритмах, - при политике «узел первого обращения»
+// страницы распределяются между узлами NUMA этих потоков
+template <typename Type, typename Alloc = std::allocator<Type>>
+SimpleVector<Type, Alloc> ParallelMakeVector(size_t size, const ParallelOptions& options = {},
+                                             const Alloc& alloc = Alloc()) {
+    SimpleVector<Type, Alloc> result(Reserve(size), alloc);
+    parallel_detail::ParallelAppend(result, size, options, [](Type* first, size_t n) {
+        std::uninitialized_value_construct_n(first, n);
+    });
+    return result;
+}
+
+// Создаёт вектор из size элементов, инициализированных значением value
+template <typename Type, typename Alloc = std::allocator<Type>>
+SimpleVector<Type, Alloc> ParallelMakeVector(size_t size, const Type& value, const ParallelOptions& options = {},
+                                             const Alloc& alloc = Alloc()) {
+    SimpleVector<Type, Alloc> result(Reserve(size), alloc);
+    parallel_detail::ParallelAppend(result, size, options, [&value](Type* first, size_t n) {
+        std::uninitialized_fill_n(first, n, value);
+    });
+    return result;
+}
+
+// Присваивает всем элементам значение value
+template <typename Type, typename... Params>
+void ParallelFill(SimpleVector<Type, Params...>& v, const Type& value, const ParallelOptions& options = {}) {
+    Type* data = v.begin();
+    parallel_detail::ForEachChunk(data, v.GetSize(), options, [&](size_t b, size_t e) {
+        std::fill(data + b, data + e, value);
+    });
+}
+
+// Присваивает элементам последовательные значения, начиная с first_value, как std::iota
+template <typename Type, typename... Params>
+void ParallelIota(SimpleVector<Type, Params...>& v, Type first_value, const ParallelOptions& options = {}) {
+    Type* data = v.begin();
+    parallel_detail::ForEachChunk(data, v.GetSize(), options, [&](size_t b, size_t e) {
+        std::iota(data + b, data + e, static_cast<Type>(first_value + static_cast<Type>(b)));
+    });
+}
+
+// Заменяет каждый элемент x на f(x)
+template <typename Type, typename... Params, typename F>
+void ParallelTransform(SimpleVector<Type, Params...>& v, F f, const ParallelOptions& options = {}) {
+    Type* data = v.begin();
+    parallel_detail::ForEachChunk(data, v.GetSize(), options, [&](size_t b, size_t e) {
+        std::transform(data + b, data + e, data + b, f);
+    });
+}
+
+// Сворачивает элементы операцией op, начиная с init, как std::reduce.
+// Каждый кусок сворачивается от identity - нейтрального элемента op, - а затем
+// результаты кусков объединяются с init той же операцией по порядку. Поэтому op должна
+// быть ассоциативной, принимать и (T, Type), и (T, T) и одинаково обрабатывать
+// элементы и частичные суммы: выражения вида acc + x * x так свернуть нельзя
+template <typename Type, typename... Params, typename T, typename Op>
+T ParallelReduce(const SimpleVector<Type, Params...>& v, T init, T identity, Op op, const ParallelOptions& options = {}) {
+    static_assert(std::is_convertible_v<std::invoke_result_t<Op&, T, const Type&>, T>
+                  && std::is_convertible_v<std::invoke_result_t<Op&, T, T>, T>);
+    const Type* data = v.begin();
+    const size_t count = v.GetSize();
+    ThreadPool& pool = parallel_detail::PoolOf(options);
+    if (count < options.serial_threshold || pool.GetThreadCount() == 0) {
+        return std::accumulate(data, data + count, std::move(init), op);
+    }
+    const std::vector<size_t> bounds = parallel_detail::ChunkBounds(
+        data, count, (pool.GetThreadCount() + 1) * std::max<size_t>(options.chunks_per_thread, 1));
+    std::vector<std::optional<T>> partial(bounds.size() - 1);
+    parallel_detail::RunTasks(pool, partial.size(), [&](size_t i) {
+        partial[i].emplace(std::accumulate(data + bounds[i], data + bounds[i + 1], identity, op));
+    });
+    for (auto& value : partial) {
+        init = op(std::move(init), std::move(*value));
+    }
+    return init;
+}
+
+// То же с нейтральным элементом T{}: подходит для сложения, побитового ИЛИ и
+// других операций, для которых T{} нейтрален
+template <typename Type, typename... Params, typename T, typename Op = std::plus<>>
+T ParallelReduce(const SimpleVector<Type, Params...>& v, T init, Op op = {}, const ParallelOptions& options = {}) {
+    return ParallelReduce(v, std::move(init), T{}, std::move(op), options);
+}
+
+// Сортирует элементы: куски сортируются параллельно, затем попарно сливаются
+// параллельными раундами std::inplace_merge
+template <typename Type, typename... Params, typename Compare = std::less<>>
+void ParallelSort(SimpleVector<Type, Params...>& v, Compare comp = {}, const ParallelOptions& options = {}) {
+    Type* data = v.begin();
+    const size_t count = v.GetSize();
+    ThreadPool& pool = parallel_detail::PoolOf(options);
+    if (count < options.serial_threshold || pool.GetThreadCount() == 0) {
+        std::sort(data, data + count, comp);
+        return;
+    }
+    std::vector<size_t> bounds = parallel_detail::ChunkBounds(data, count, pool.GetThreadCount() + 1);
+    parallel_detail::RunTasks(pool, bounds.size() - 1, [&](size_t i) {
+        std::sort(data + bounds[i], data + bounds[i + 1], comp);
+    });
+    while (bounds.size() > 2) {
+        const size_t pairs = (bounds.size() - 1) / 2;
+        parallel_detail::RunTasks(pool, pairs, [&](size_t i) {
+            std::inplace_merge(data + bounds[2 * i], data + bounds[2 * i + 1], data + bounds[2 * i + 2], comp);
+        });
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged.back() != count) {
+            merged.push_back(count);
+        }
+        bounds = std::move(merged);
+    }
+}
+
+// Возвращает итератор на первый элемент, равный value, или end()
+template <typename Type, typename... Params>
+auto ParallelFind(const SimpleVector<Type, Params...>& v, const Type& value, const ParallelOptions& options = {}) {
+    // Кусок проверяет, не нашёл ли уже кто-то совпадение раньше, после каждого блока
+    constexpr size_t kBlock = 4096;
+    const Type* data = v.begin();
+    const size_t count = v.GetSize();
+    std::atomic<size_t> found{count};
+    parallel_detail::ForEachChunk(data, count, options, [&](size_t b, size_t e) {
+        for (size_t block = b; block < e && block < found.load(std::memory_order_relaxed); block += kBlock) {
+            const Type* last = data + std::min(block + kBlock, e);
+            const Type* it = std::find(data + block, last, value);
+            if (it != last) {
+                size_t index = it - data;
+                size_t current = found.load(std::memory_order_relaxed);
+                while (index < current && !found.compare_exchange_weak(current, index, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    });
+    return v.begin() + found.load();
+}
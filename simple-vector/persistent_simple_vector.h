@@ -0,0 +1,545 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "simple_vector.h"
+
+// Вектор со структурным разделением памяти: копирование стоит O(1), а копии
+// делят между собой неизменённые части. Элементы лежат в листьях по 32 штуки
+// в префиксном дереве с ветвлением 32 (как persistent vector в Clojure);
+// последний неполный лист - «хвост» - хранится отдельно, поэтому PushBack и PopBack
+// в среднем O(1), а Set и доступ по индексу - O(log32 n).
+// Узлы считают ссылки атомарно. Изменение копирует только разделяемые узлы на пути
+// к элементу; узлы, принадлежащие одному вектору, меняются на месте.
+// Разные объекты можно использовать из разных потоков, даже если они разделяют узлы;
+// один объект, как и SimpleVector, нельзя менять одновременно из нескольких потоков.
+// Изменения дают строгую гарантию: узлы копируются до того, как меняется содержимое
+template <typename Type>
+class PersistentSimpleVector {
+    static constexpr size_t kBits = 5;
+    static constexpr size_t kWidth = size_t(1) << kBits;
+    static constexpr size_t kMask = kWidth - 1;
+
+    struct Node {
+        explicit Node(bool leaf) noexcept
+            : is_leaf(leaf) {
+        }
+
+        std::atomic<size_t> refs{1};
+        const bool is_leaf;
+    };
+
+    struct Leaf;
+    struct Branch;
+
+    // Владеющая ссылка на узел
+    class NodePtr {
+    public:
+        NodePtr() noexcept = default;
+
+        // Принимает только что созданный узел со счётчиком 1
+        explicit NodePtr(Node* node) noexcept
+            : node_(node) {
+        }
+
+        NodePtr(const NodePtr& other) noexcept
+            : node_(other.node_) {
+            if (node_ != nullptr) {
+                node_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        NodePtr(NodePtr&& other) noexcept
+            : node_(std::exchange(other.node_, nullptr)) {
+        }
+
+        NodePtr& operator=(NodePtr other) noexcept {
+            std::swap(node_, other.node_);
+            return *this;
+        }
+
+        ~NodePtr() {
+            Reset();
+        }
+
+        void Reset() noexcept {
+            Node* node = std::exchange(node_, nullptr);
+            if (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (node->is_leaf) {
+                    delete static_cast<Leaf*>(node);
+                } else {
+                    delete static_cast<Branch*>(node);
+                }
+            }
+        }
+
+        explicit operator bool() const noexcept {
+            return node_ != nullptr;
+        }
+
+        // Узел доступен только через эту ссылку, и его можно менять на месте
+        bool IsUnique() const noexcept {
+            return node_->refs.load(std::memory_order_acquire) == 1;
+        }
+
+        bool IsLeaf() const noexcept {
+            return node_->is_leaf;
+        }
+
+        Leaf* AsLeaf() const noexcept {
+            assert(node_->is_leaf);
+            return static_cast<Leaf*>(node_);
+        }
+
+        Branch* AsBranch() const noexcept {
+            assert(!node_->is_leaf);
+            return static_cast<Branch*>(node_);
+        }
+
+    private:
+        Node* node_ = nullptr;
+    };
+
+    struct Leaf : Node {
+        Leaf() noexcept
+            : Node(true) {
+        }
+
+        Leaf(const Leaf& other)
+            : Node(true) {
+            std::uninitialized_copy_n(other.Data(), other.count, Data());
+            count = other.count;
+        }
+
+        ~Leaf() {
+            std::destroy_n(Data(), count);
+        }
+
+        Type* Data() noexcept {
+            return std::launder(reinterpret_cast<Type*>(storage));
+        }
+
+        const Type* Data() const noexcept {
+            return std::launder(reinterpret_cast<const Type*>(storage));
+        }
+
+        size_t count = 0;
+        alignas(Type) unsigned char storage[sizeof(Type) * kWidth];
+    };
+
+    struct Branch : Node {
+        Branch() noexcept
+            : Node(false) {
+        }
+
+        Branch(const Branch& other) noexcept
+            : Node(false) {
+            std::copy(std::begin(other.children), std::end(other.children), std::begin(children));
+        }
+
+        NodePtr children[kWidth];
+    };
+
+public:
+    class ConstIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        ConstIterator() = default;
+
+        ConstIterator(const PersistentSimpleVector* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        // Лист запоминается, поэтому последовательный обход спускается по дереву раз на 32 элемента
+        reference operator*() const noexcept {
+            if (leaf_ == nullptr || index_ - leaf_base_ >= kWidth) {
+                leaf_ = owner_->LeafFor(index_)->Data();
+                leaf_base_ = index_ & ~kMask;
+            }
+            return leaf_[index_ - leaf_base_];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        ConstIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            ConstIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        ConstIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        ConstIterator operator--(int) noexcept {
+            ConstIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        ConstIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend ConstIterator operator+(ConstIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend ConstIterator operator+(difference_type n, ConstIterator it) noexcept {
+            return it += n;
+        }
+
+        friend ConstIterator operator-(ConstIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        const PersistentSimpleVector* owner_ = nullptr;
+        size_t index_ = 0;
+        mutable const Type* leaf_ = nullptr;
+        mutable size_t leaf_base_ = 0;
+    };
+
+    PersistentSimpleVector() noexcept = default;
+
+    PersistentSimpleVector(std::initializer_list<Type> init) {
+        for (const Type& item : init) {
+            PushBack(item);
+        }
+    }
+
+    // Копирует элементы SimpleVector: O(n), листья заполняются на месте
+    template <typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+    explicit PersistentSimpleVector(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v) {
+        for (const Type& item : v) {
+            PushBack(item);
+        }
+    }
+
+    // Копирование за O(1): копии делят все узлы
+    PersistentSimpleVector(const PersistentSimpleVector&) noexcept = default;
+    PersistentSimpleVector& operator=(const PersistentSimpleVector&) noexcept = default;
+
+    PersistentSimpleVector(PersistentSimpleVector&& other) noexcept
+        : root_(std::move(other.root_))
+        , tail_(std::move(other.tail_))
+        , size_(std::exchange(other.size_, 0))
+        , shift_(std::exchange(other.shift_, kBits)) {
+    }
+
+    PersistentSimpleVector& operator=(PersistentSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            root_ = std::move(rhs.root_);
+            tail_ = std::move(rhs.tail_);
+            size_ = std::exchange(rhs.size_, 0);
+            shift_ = std::exchange(rhs.shift_, kBits);
+        }
+        return *this;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Элементы доступны только для чтения: запись идёт через Set
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return LeafFor(index)->Data()[index & kMask];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return (*this)[index];
+    }
+
+    ConstIterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    ConstIterator end() const noexcept {
+        return {this, size_};
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Заменяет элемент с индексом index; разделяемые узлы на пути к нему копируются
+    void Set(size_t index, const Type& value) {
+        Type copy(value);
+        Set(index, std::move(copy));
+    }
+
+    void Set(size_t index, Type&& value) {
+        assert(index < size_);
+        Type& slot = MutableSlot(index);
+        slot = std::move(value);
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        if (tail_ && tail_.AsLeaf()->count < kWidth) {
+            MakeUnique(tail_);
+            Leaf* tail = tail_.AsLeaf();
+            ::new (static_cast<void*>(tail->Data() + tail->count)) Type(std::forward<Args>(args)...);
+            ++tail->count;
+            ++size_;
+            return;
+        }
+        NodePtr new_tail(new Leaf);
+        ::new (static_cast<void*>(new_tail.AsLeaf()->Data())) Type(std::forward<Args>(args)...);
+        new_tail.AsLeaf()->count = 1;
+        if (tail_) {
+            // Полный хвост переезжает в дерево
+            if ((size_ >> kBits) > (size_t(1) << shift_)) {
+                NodePtr new_root(new Branch);
+                new_root.AsBranch()->children[0] = root_;
+                new_root.AsBranch()->children[1] = NewPath(shift_, tail_);
+                root_ = std::move(new_root);
+                shift_ += kBits;
+            } else {
+                PushTail(shift_, root_, tail_);
+            }
+        }
+        tail_ = std::move(new_tail);
+        ++size_;
+    }
+
+    void PopBack() {
+        assert(size_ > 0);
+        if (size_ == 1) {
+            Clear();
+            return;
+        }
+        if (tail_.AsLeaf()->count > 1) {
+            MakeUnique(tail_);
+            Leaf* tail = tail_.AsLeaf();
+            --tail->count;
+            std::destroy_at(tail->Data() + tail->count);
+            --size_;
+            return;
+        }
+        // Хвост опустел: его место занимает последний лист дерева
+        NodePtr new_tail = LeafPtrFor(size_ - 2);
+        PopTail(shift_, root_);
+        if (shift_ > kBits && !root_.AsBranch()->children[1]) {
+            NodePtr only_child = root_.AsBranch()->children[0];
+            root_ = std::move(only_child);
+            shift_ -= kBits;
+        }
+        tail_ = std::move(new_tail);
+        --size_;
+    }
+
+    void Clear() noexcept {
+        root_.Reset();
+        tail_.Reset();
+        size_ = 0;
+        shift_ = kBits;
+    }
+
+    void swap(PersistentSimpleVector& other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(tail_, other.tail_);
+        std::swap(size_, other.size_);
+        std::swap(shift_, other.shift_);
+    }
+
+    // Копирует элементы в непрерывный SimpleVector, по листу за раз
+    template <typename Alloc = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth, typename StatsPolicy = NoStats>
+    SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy> ToSimpleVector(const Alloc& alloc = Alloc()) const {
+        SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy> result(ReserveProxyObj(size_), alloc);
+        result.AppendWith(size_, [this](Type* dest, size_t count) {
+            size_t done = 0;
+            try {
+                while (done < count) {
+                    const Leaf* leaf = LeafFor(done);
+                    std::uninitialized_copy_n(leaf->Data(), leaf->count, dest + done);
+                    done += leaf->count;
+                }
+            } catch (...) {
+                std::destroy_n(dest, done);
+                throw;
+            }
+        });
+        return result;
+    }
+
+private:
+    // Индекс первого элемента хвоста
+    size_t TailOffset() const noexcept {
+        return size_ < kWidth ? 0 : ((size_ - 1) >> kBits) << kBits;
+    }
+
+    const Leaf* LeafFor(size_t index) const noexcept {
+        if (index >= TailOffset()) {
+            return tail_.AsLeaf();
+        }
+        const Branch* node = root_.AsBranch();
+        for (size_t level = shift_; level > kBits; level -= kBits) {
+            node = node->children[(index >> level) & kMask].AsBranch();
+        }
+        return node->children[(index >> kBits) & kMask].AsLeaf();
+    }
+
+    NodePtr LeafPtrFor(size_t index) const noexcept {
+        const Branch* node = root_.AsBranch();
+        for (size_t level = shift_; level > kBits; level -= kBits) {
+            node = node->children[(index >> level) & kMask].AsBranch();
+        }
+        return node->children[(index >> kBits) & kMask];
+    }
+
+    // Заменяет разделяемый узел его копией. Содержимое не меняется,
+    // поэтому исключение при копировании ничего не портит
+    static void MakeUnique(NodePtr& node) {
+        if (node.IsUnique()) {
+            return;
+        }
+        NodePtr copy(node.IsLeaf() ? static_cast<Node*>(new Leaf(*node.AsLeaf()))
+                                   : static_cast<Node*>(new Branch(*node.AsBranch())));
+        node = std::move(copy);
+    }
+
+    Type& MutableSlot(size_t index) {
+        if (index >= TailOffset()) {
+            MakeUnique(tail_);
+            return tail_.AsLeaf()->Data()[index - TailOffset()];
+        }
+        NodePtr* node = &root_;
+        for (size_t level = shift_; level > 0; level -= kBits) {
+            MakeUnique(*node);
+            node = &node->AsBranch()->children[(index >> level) & kMask];
+        }
+        MakeUnique(*node);
+        return node->AsLeaf()->Data()[index & kMask];
+    }
+
+    static NodePtr NewPath(size_t level, const NodePtr& leaf) {
+        if (level == 0) {
+            return leaf;
+        }
+        NodePtr branch(new Branch);
+        branch.AsBranch()->children[0] = NewPath(level - kBits, leaf);
+        return branch;
+    }
+
+    // Вставляет полный лист tail в дерево на место элементов [size_ - kWidth, size_)
+    void PushTail(size_t level, NodePtr& parent, const NodePtr& tail) {
+        const size_t child_index = ((size_ - 1) >> level) & kMask;
+        if (!parent) {
+            parent = NodePtr(new Branch);
+        } else {
+            MakeUnique(parent);
+        }
+        NodePtr& child = parent.AsBranch()->children[child_index];
+        if (level == kBits) {
+            child = tail;
+        } else if (child) {
+            PushTail(level - kBits, child, tail);
+        } else {
+            child = NewPath(level - kBits, tail);
+        }
+    }
+
+    // Убирает из дерева последний лист. Узлы, оставшиеся без детей, удаляются
+    void PopTail(size_t level, NodePtr& node) {
+        const size_t child_index = ((size_ - 2) >> level) & kMask;
+        if (level > kBits) {
+            MakeUnique(node);
+            NodePtr& child = node.AsBranch()->children[child_index];
+            PopTail(level - kBits, child);
+            if (!child && child_index == 0) {
+                node.Reset();
+            }
+        } else if (child_index == 0) {
+            node.Reset();
+        } else {
+            MakeUnique(node);
+            node.AsBranch()->children[child_index].Reset();
+        }
+    }
+
+    NodePtr root_;
+    NodePtr tail_;
+    size_t size_ = 0;
+    size_t shift_ = kBits;
+};
@@ -0,0 +1,397 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include "simple_vector.h"
+
+// Повторное использование буферов короткоживущих векторов.
+// Освобождённый буфер не возвращается в malloc, а кладётся в список свободных буферов
+// своего размерного класса (степени двойки от 16 байт до 1 МБ) в кеше текущего потока.
+// Когда список потока полон, половина его уходит в общий пул, когда пуст -
+// пополняется из общего пула. Выделение и освобождение в кеше потока идут без блокировок.
+// Буферы больше 1 МБ не кешируются. Поток, уходящий в простой, вызывает Trim,
+// а при завершении потока его кеш сам переходит в общий пул
+
+// Ограничения на число буферов в одном размерном классе
+struct RecyclerLimits {
+    size_t thread_buffers_per_class = 64;
+    size_t global_buffers_per_class = 1024;
+};
+
+// Счётчики за всё время работы и текущий объём удерживаемой памяти
+struct RecyclerStats {
+    size_t thread_hits = 0;   // буфер взят из кеша потока
+    size_t global_hits = 0;   // буфер взят из общего пула
+    size_t misses = 0;        // буфер выделен через operator new
+    size_t bypassed = 0;      // буфер больше 1 МБ, выделен мимо кешей
+    size_t retained_buffers = 0;
+    size_t retained_bytes = 0;
+
+    // Доля выделений, обслуженных кешами, без учёта bypassed
+    double HitRate() const noexcept {
+        const size_t total = thread_hits + global_hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(thread_hits + global_hits) / total;
+    }
+};
+
+namespace recycling_detail {
+
+inline constexpr size_t kMinClassShift = 4;
+inline constexpr size_t kMaxClassShift = 20;
+inline constexpr size_t kClassCount = kMaxClassShift - kMinClassShift + 1;
+inline constexpr size_t kMaxBufferBytes = size_t(1) << kMaxClassShift;
+
+// Наименьший класс, в который помещается bytes байт, bytes <= kMaxBufferBytes
+inline size_t SizeClass(size_t bytes) noexcept {
+    const size_t rounded = std::max(bytes, size_t(1) << kMinClassShift);
+    return 64 - __builtin_clzll(rounded - 1) - kMinClassShift;
+}
+
+inline size_t ClassBytes(size_t size_class) noexcept {
+    return size_t(1) << (size_class + kMinClassShift);
+}
+
+// Свободный буфер хранит указатель на следующий прямо в себе
+struct FreeNode {
+    FreeNode* next;
+};
+
+struct FreeList {
+    FreeNode* head = nullptr;
+    size_t count = 0;
+
+    void Push(void* buffer) noexcept {
+        head = new (buffer) FreeNode{head};
+        ++count;
+    }
+
+    void* Pop() noexcept {
+        FreeNode* node = head;
+        if (node != nullptr) {
+            head = node->next;
+            --count;
+        }
+        return node;
+    }
+};
+
+// Счётчик, который пишет только поток-владелец, а читают все: обновление без RMW-инструкций
+inline void Bump(std::atomic<size_t>& counter, std::ptrdiff_t delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+}  // namespace recycling_detail
+
+class BufferRecycler {
+public:
+    // Единственный экземпляр намеренно не разрушается: буферы векторов
+    // со статическим временем жизни могут освобождаться уже после main
+    static BufferRecycler& Instance() {
+        static BufferRecycler* recycler = new BufferRecycler;
+        return *recycler;
+    }
+
+    BufferRecycler(const BufferRecycler&) = delete;
+    BufferRecycler& operator=(const BufferRecycler&) = delete;
+
+    // Память под bytes байт с выравниванием operator new.
+    // Allocate и Deallocate не встраиваются: иначе они утяжеляют горячий цикл PushBack
+    __attribute__((noinline)) void* Allocate(size_t bytes) {
+        using namespace recycling_detail;
+        if (bytes > kMaxBufferBytes) {
+            std::lock_guard guard(mutex_);
+            ++orphan_stats_.bypassed;
+            return ::operator new(bytes);
+        }
+        const size_t size_class = SizeClass(bytes);
+        ThreadCache* cache = LocalCache();
+        if (cache == nullptr) {
+            // Кеш потока уже разрушен: поток завершается
+            std::lock_guard guard(mutex_);
+            if (void* buffer = TakeGlobal(size_class)) {
+                ++orphan_stats_.global_hits;
+                return buffer;
+            }
+            ++orphan_stats_.misses;
+            return ::operator new(ClassBytes(size_class));
+        }
+        FreeList& list = cache->lists[size_class];
+        if (list.count == 0 && Refill(*cache, size_class) > 0) {
+            Bump(cache->global_hits, 1);
+        } else if (list.count == 0) {
+            Bump(cache->misses, 1);
+            return ::operator new(ClassBytes(size_class));
+        } else {
+            Bump(cache->thread_hits, 1);
+        }
+        Bump(cache->retained_buffers, -1);
+        Bump(cache->retained_bytes, -static_cast<std::ptrdiff_t>(ClassBytes(size_class)));
+        return list.Pop();
+    }
+
+    // Освобождает память, выделенную Allocate с тем же bytes
+    __attribute__((noinline)) void Deallocate(void* buffer, size_t bytes) noexcept {
+        using namespace recycling_detail;
+        if (bytes > kMaxBufferBytes) {
+            ::operator delete(buffer);
+            return;
+        }
+        const size_t size_class = SizeClass(bytes);
+        ThreadCache* cache = LocalCache();
+        if (cache == nullptr) {
+            std::lock_guard guard(mutex_);
+            PutGlobal(buffer, size_class);
+            return;
+        }
+        FreeList& list = cache->lists[size_class];
+        if (list.count >= limits_.thread_buffers_per_class.load(std::memory_order_relaxed)) {
+            Spill(*cache, size_class, list.count / 2 + 1);
+        }
+        if (list.count < limits_.thread_buffers_per_class.load(std::memory_order_relaxed)) {
+            list.Push(buffer);
+            Bump(cache->retained_buffers, 1);
+            Bump(cache->retained_bytes, ClassBytes(size_class));
+        } else {
+            // Лимит потока равен нулю
+            std::lock_guard guard(mutex_);
+            PutGlobal(buffer, size_class);
+        }
+    }
+
+    // Возвращает в operator delete все буферы кеша текущего потока и общего пула.
+    // Кеши других потоков не трогаются: каждый поток чистит свой сам
+    void Trim() noexcept {
+        using namespace recycling_detail;
+        if (ThreadCache* cache = LocalCache()) {
+            for (FreeList& list : cache->lists) {
+                while (void* buffer = list.Pop()) {
+                    ::operator delete(buffer);
+                }
+            }
+            cache->retained_buffers.store(0, std::memory_order_relaxed);
+            cache->retained_bytes.store(0, std::memory_order_relaxed);
+        }
+        std::lock_guard guard(mutex_);
+        for (FreeList& list : global_) {
+            while (void* buffer = list.Pop()) {
+                ::operator delete(buffer);
+            }
+        }
+        global_retained_buffers_ = 0;
+        global_retained_bytes_ = 0;
+    }
+
+    RecyclerStats GetStats() const {
+        std::lock_guard guard(mutex_);
+        RecyclerStats stats = orphan_stats_;
+        for (const ThreadCache* cache = threads_; cache != nullptr; cache = cache->next) {
+            stats.thread_hits += cache->thread_hits.load(std::memory_order_relaxed);
+            stats.global_hits += cache->global_hits.load(std::memory_order_relaxed);
+            stats.misses += cache->misses.load(std::memory_order_relaxed);
+            stats.retained_buffers += cache->retained_buffers.load(std::memory_order_relaxed);
+            stats.retained_bytes += cache->retained_bytes.load(std::memory_order_relaxed);
+        }
+        stats.retained_buffers += global_retained_buffers_;
+        stats.retained_bytes += global_retained_bytes_;
+        return stats;
+    }
+
+    // Новые лимиты действуют на следующие освобождения; лишние буферы не освобождаются сразу
+    void SetLimits(const RecyclerLimits& limits) noexcept {
+        limits_.thread_buffers_per_class.store(limits.thread_buffers_per_class, std::memory_order_relaxed);
+        limits_.global_buffers_per_class.store(limits.global_buffers_per_class, std::memory_order_relaxed);
+    }
+
+    RecyclerLimits GetLimits() const noexcept {
+        return {limits_.thread_buffers_per_class.load(std::memory_order_relaxed),
+                limits_.global_buffers_per_class.load(std::memory_order_relaxed)};
+    }
+
+private:
+    // Кеш одного потока. Списки трогает только поток-владелец,
+    // счётчики читает GetStats, поэтому они атомарные
+    struct ThreadCache {
+        recycling_detail::FreeList lists[recycling_detail::kClassCount];
+        std::atomic<size_t> thread_hits{0};
+        std::atomic<size_t> global_hits{0};
+        std::atomic<size_t> misses{0};
+        std::atomic<size_t> retained_buffers{0};
+        std::atomic<size_t> retained_bytes{0};
+        ThreadCache* prev = nullptr;
+        ThreadCache* next = nullptr;
+
+        ThreadCache() noexcept {
+            Instance().Register(this);
+        }
+
+        ~ThreadCache() {
+            Instance().Unregister(this);
+            IsThreadCacheDestroyed() = true;
+        }
+    };
+
+    struct AtomicLimits {
+        std::atomic<size_t> thread_buffers_per_class;
+        std::atomic<size_t> global_buffers_per_class;
+    };
+
+    BufferRecycler() noexcept {
+        SetLimits(RecyclerLimits{});
+    }
+
+    // Флаг без деструктора переживает кеш потока
+    static bool& IsThreadCacheDestroyed() noexcept {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static ThreadCache* LocalCache() noexcept {
+        if (IsThreadCacheDestroyed()) {
+            return nullptr;
+        }
+        thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    void Register(ThreadCache* cache) noexcept {
+        std::lock_guard guard(mutex_);
+        cache->next = threads_;
+        if (threads_ != nullptr) {
+            threads_->prev = cache;
+        }
+        threads_ = cache;
+    }
+
+    // Переносит буферы и счётчики завершающегося потока в общий пул
+    void Unregister(ThreadCache* cache) noexcept {
+        std::lock_guard guard(mutex_);
+        for (size_t size_class = 0; size_class < recycling_detail::kClassCount; ++size_class) {
+            while (void* buffer = cache->lists[size_class].Pop()) {
+                PutGlobal(buffer, size_class);
+            }
+        }
+        orphan_stats_.thread_hits += cache->thread_hits.load(std::memory_order_relaxed);
+        orphan_stats_.global_hits += cache->global_hits.load(std::memory_order_relaxed);
+        orphan_stats_.misses += cache->misses.load(std::memory_order_relaxed);
+        (cache->prev != nullptr ? cache->prev->next : threads_) = cache->next;
+        if (cache->next != nullptr) {
+            cache->next->prev = cache->prev;
+        }
+    }
+
+    // Берёт из общего пула до половины лимита потока; возвращает число взятых буферов
+    size_t Refill(ThreadCache& cache, size_t size_class) {
+        recycling_detail::FreeList& list = cache.lists[size_class];
+        const size_t wanted = std::max<size_t>(limits_.thread_buffers_per_class.load(std::memory_order_relaxed) / 2, 1);
+        std::lock_guard guard(mutex_);
+        size_t taken = 0;
+        for (; taken < wanted; ++taken) {
+            void* buffer = TakeGlobal(size_class);
+            if (buffer == nullptr) {
+                break;
+            }
+            list.Push(buffer);
+        }
+        recycling_detail::Bump(cache.retained_buffers, taken);
+        recycling_detail::Bump(cache.retained_bytes, taken * recycling_detail::ClassBytes(size_class));
+        return taken;
+    }
+
+    // Отдаёт count буферов из кеша потока в общий пул одной блокировкой
+    void Spill(ThreadCache& cache, size_t size_class, size_t count) noexcept {
+        recycling_detail::FreeList& list = cache.lists[size_class];
+        count = std::min(count, list.count);
+        std::lock_guard guard(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            PutGlobal(list.Pop(), size_class);
+        }
+        recycling_detail::Bump(cache.retained_buffers, -static_cast<std::ptrdiff_t>(count));
+        recycling_detail::Bump(cache.retained_bytes, -static_cast<std::ptrdiff_t>(count * recycling_detail::ClassBytes(size_class)));
+    }
+
+    // Вызываются под mutex_
+    void* TakeGlobal(size_t size_class) noexcept {
+        void* buffer = global_[size_class].Pop();
+        if (buffer != nullptr) {
+            --global_retained_buffers_;
+            global_retained_bytes_ -= recycling_detail::ClassBytes(size_class);
+        }
+        return buffer;
+    }
+
+    void PutGlobal(void* buffer, size_t size_class) noexcept {
+        if (global_[size_class].count >= limits_.global_buffers_per_class.load(std::memory_order_relaxed)) {
+            ::operator delete(buffer);
+            return;
+        }
+        global_[size_class].Push(buffer);
+        ++global_retained_buffers_;
+        global_retained_bytes_ += recycling_detail::ClassBytes(size_class);
+    }
+
+    mutable std::mutex mutex_;
+    recycling_detail::FreeList global_[recycling_detail::kClassCount];
+    size_t global_retained_buffers_ = 0;
+    size_t global_retained_bytes_ = 0;
+    // Счётчики завершившихся потоков и выделений мимо кешей потоков
+    RecyclerStats orphan_stats_;
+    ThreadCache* threads_ = nullptr;
+    AtomicLimits limits_;
+};
+
+// Аллокатор, берущий буферы у BufferRecycler. Не хранит состояния,
+// все экземпляры взаимозаменяемы. Типы с выравниванием больше, чем у operator new,
+// выделяются напрямую
+template <typename T>
+class RecyclingAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    RecyclingAllocator() noexcept = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        } else {
+            return static_cast<T*>(BufferRecycler::Instance().Allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        } else {
+            BufferRecycler::Instance().Deallocate(p, n * sizeof(T));
+        }
+    }
+
+    template <typename U>
+    friend bool operator==(const RecyclingAllocator&, const RecyclingAllocator<U>&) noexcept {
+        return true;
+    }
+
+    template <typename U>
+    friend bool operator!=(const RecyclingAllocator&, const RecyclingAllocator<U>&) noexcept {
+        return false;
+    }
+};
+
+namespace recycling {
+
+// SimpleVector, повторно использующий освобождённые буферы
+template <typename Type, typename GrowthPolicy = DoublingGrowth, typename StatsPolicy = NoStats>
+using SimpleVector = ::SimpleVector<Type, RecyclingAllocator<Type>, GrowthPolicy, StatsPolicy>;
+
+}  // namespace recycling
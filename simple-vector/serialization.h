@@ -0,0 +1,366 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "simple_vector.h"
+
+// Двоичная сериализация SimpleVector тривиально копируемых элементов.
+// Формат (порядок байтов - родной для машины, на которой записан файл; метка в заголовке
+// позволяет читателю с другим порядком байтов отвергнуть поток, а не прочитать мусор):
+//     SerializedVectorHeader                  - магическое число, версия, размер элемента,
+//                                               число элементов или kUnknownCount, метка порядка байтов;
+//     { uint64 n; n * element_size байт }...  - куски элементов;
+//     uint64 0                                - конец кусков;
+//     uint64 checksum                         - VectorChecksum всех байтов элементов.
+// Serialize пишет вектор одним куском, то есть одной записью в поток, а Deserialize
+// читает куски сразу в неинициализированную память вектора частями до kReadSliceBytes.
+// VectorStreamWriter и VectorStreamReader передают вектор по частям, не держа его целиком в памяти.
+// Ошибки формата и ввода-вывода сообщаются исключением SerializationError
+
+class SerializationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct SerializedVectorHeader {
+    static constexpr char kMagic[8] = {'S', 'V', 'S', 'E', 'R', '\0', '\0', '\0'};
+    static constexpr std::uint32_t kVersion = 2;
+    static constexpr std::uint64_t kUnknownCount = std::numeric_limits<std::uint64_t>::max();
+    // Записывается в родном порядке байтов; на машине с обратным порядком читается как kSwappedByteOrder
+    static constexpr std::uint32_t kByteOrder = 0x01020304;
+    static constexpr std::uint32_t kSwappedByteOrder = 0x04030201;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t element_size;
+    std::uint64_t count;
+    std::uint32_t byte_order;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(SerializedVectorHeader) == 32);
+
+// Быстрая некриптографическая контрольная сумма в духе xxHash64 (но не совместимая с ним):
+// четыре независимые 64-битные полосы по 8 байт за шаг. Данные можно подавать частями любого размера
+class VectorChecksum {
+public:
+    void Update(const void* data, size_t size) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        total_ += size;
+        if (tail_size_ > 0) {
+            const size_t take = std::min(size, kBlock - tail_size_);
+            std::memcpy(tail_ + tail_size_, bytes, take);
+            tail_size_ += take;
+            bytes += take;
+            size -= take;
+            if (tail_size_ < kBlock) {
+                return;
+            }
+            Consume(tail_);
+            tail_size_ = 0;
+        }
+        for (; size >= kBlock; bytes += kBlock, size -= kBlock) {
+            Consume(bytes);
+        }
+        std::memcpy(tail_, bytes, size);
+        tail_size_ = size;
+    }
+
+    std::uint64_t Finish() const noexcept {
+        std::uint64_t hash = Rotl(lanes_[0], 1) + Rotl(lanes_[1], 7) + Rotl(lanes_[2], 12) + Rotl(lanes_[3], 18);
+        for (std::uint64_t lane : lanes_) {
+            hash = (hash ^ Round(0, lane)) * kPrime1 + kPrime4;
+        }
+        hash += total_;
+        for (size_t i = 0; i < tail_size_; ++i) {
+            hash = Rotl(hash ^ (tail_[i] * kPrime5), 11) * kPrime1;
+        }
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        return hash ^ (hash >> 32);
+    }
+
+private:
+    static constexpr size_t kBlock = 32;
+    static constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    static constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+    static std::uint64_t Rotl(std::uint64_t x, int r) noexcept {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static std::uint64_t Round(std::uint64_t acc, std::uint64_t input) noexcept {
+        return Rotl(acc + input * kPrime2, 31) * kPrime1;
+    }
+
+    void Consume(const unsigned char* block) noexcept {
+        for (size_t i = 0; i < 4; ++i) {
+            std::uint64_t word;
+            std::memcpy(&word, block + i * 8, 8);
+            lanes_[i] = Round(lanes_[i], word);
+        }
+    }
+
+    std::uint64_t lanes_[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    unsigned char tail_[kBlock] = {};
+    size_t tail_size_ = 0;
+    std::uint64_t total_ = 0;
+};
+
+// Пишет вектор в поток кусками. Число элементов можно объявить заранее - тогда
+// Finish проверит, что записано именно столько, - или оставить неизвестным
+template <typename Type>
+class VectorStreamWriter {
+    static_assert(std::is_trivially_copyable_v<Type>, "only trivially copyable elements are serialized as bytes");
+
+public:
+    explicit VectorStreamWriter(std::ostream& out, std::uint64_t count = SerializedVectorHeader::kUnknownCount)
+        : out_(out)
+        , declared_count_(count) {
+        SerializedVectorHeader header{};
+        std::memcpy(header.magic, SerializedVectorHeader::kMagic, sizeof(header.magic));
+        header.version = SerializedVectorHeader::kVersion;
+        header.element_size = sizeof(Type);
+        header.count = count;
+        header.byte_order = SerializedVectorHeader::kByteOrder;
+        WriteRaw(&header, sizeof(header));
+    }
+
+    VectorStreamWriter(const VectorStreamWriter&) = delete;
+    VectorStreamWriter& operator=(const VectorStreamWriter&) = delete;
+
+    // Пишет count элементов одним куском
+    void Write(const Type* data, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        const std::uint64_t chunk_count = count;
+        WriteRaw(&chunk_count, sizeof(chunk_count));
+        WriteRaw(data, count * sizeof(Type));
+        checksum_.Update(data, count * sizeof(Type));
+        written_ += count;
+    }
+
+    template <typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+    void Write(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v) {
+        Write(v.begin(), v.GetSize());
+    }
+
+    // Завершает поток. Без вызова Finish читатель сочтёт данные обрезанными
+    void Finish() {
+        if (declared_count_ != SerializedVectorHeader::kUnknownCount && written_ != declared_count_) {
+            throw SerializationError("declared " + std::to_string(declared_count_) + " elements, written "
+                                     + std::to_string(written_));
+        }
+        const std::uint64_t end_marker = 0;
+        WriteRaw(&end_marker, sizeof(end_marker));
+        const std::uint64_t checksum = checksum_.Finish();
+        WriteRaw(&checksum, sizeof(checksum));
+        out_.flush();
+    }
+
+private:
+    void WriteRaw(const void* data, size_t size) {
+        if (!out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+            throw SerializationError("write to stream failed");
+        }
+    }
+
+    std::ostream& out_;
+    std::uint64_t declared_count_;
+    std::uint64_t written_ = 0;
+    VectorChecksum checksum_;
+};
+
+// Читает вектор из потока по частям. Контрольная сумма проверяется,
+// когда дочитан последний кусок
+template <typename Type>
+class VectorStreamReader {
+    static_assert(std::is_trivially_copyable_v<Type>, "only trivially copyable elements are serialized as bytes");
+
+public:
+    explicit VectorStreamReader(std::istream& in)
+        : in_(in) {
+        SerializedVectorHeader header;
+        ReadRaw(&header, sizeof(header));
+        if (std::memcmp(header.magic, SerializedVectorHeader::kMagic, sizeof(header.magic)) != 0) {
+            throw SerializationError("not a serialized SimpleVector");
+        }
+        // Версия тоже записана в порядке байтов писателя, поэтому порядок проверяется первым
+        if (header.byte_order == SerializedVectorHeader::kSwappedByteOrder) {
+            throw SerializationError("stream was written on a machine with a different byte order");
+        }
+        if (header.version != SerializedVectorHeader::kVersion) {
+            throw SerializationError("unsupported format version " + std::to_string(header.version));
+        }
+        if (header.byte_order != SerializedVectorHeader::kByteOrder) {
+            throw SerializationError("corrupted byte order mark");
+        }
+        if (header.element_size != sizeof(Type)) {
+            throw SerializationError("stream stores " + std::to_string(header.element_size)
+                                     + "-byte elements, expected " + std::to_string(sizeof(Type)));
+        }
+        declared_count_ = header.count;
+    }
+
+    VectorStreamReader(const VectorStreamReader&) = delete;
+    VectorStreamReader& operator=(const VectorStreamReader&) = delete;
+
+    // Число элементов, объявленное писателем, или SerializedVectorHeader::kUnknownCount
+    std::uint64_t GetDeclaredCount() const noexcept {
+        return declared_count_;
+    }
+
+    // Сколько элементов можно прочитать из текущего куска, не обращаясь к следующему.
+    // 0 означает конец данных: к этому моменту контрольная сумма уже проверена
+    size_t NextChunkSize() {
+        if (chunk_left_ == 0 && !finished_) {
+            std::uint64_t chunk_count;
+            ReadRaw(&chunk_count, sizeof(chunk_count));
+            if (chunk_count == 0) {
+                Finish();
+            } else if (chunk_count > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+                throw SerializationError("corrupted chunk size");
+            } else if (declared_count_ != SerializedVectorHeader::kUnknownCount
+                       && chunk_count > declared_count_ - read_) {
+                throw SerializationError("chunk exceeds the declared element count");
+            }
+            chunk_left_ = chunk_count;
+        }
+        return chunk_left_;
+    }
+
+    // Читает ровно count элементов из текущего куска, count <= NextChunkSize()
+    void ReadExactly(Type* dest, size_t count) {
+        if (count > chunk_left_) {
+            throw SerializationError("read past the end of a chunk");
+        }
+        ReadRaw(dest, count * sizeof(Type));
+        checksum_.Update(dest, count * sizeof(Type));
+        chunk_left_ -= count;
+        read_ += count;
+    }
+
+    // Читает до max_count элементов, переходя через границы кусков. Возвращает прочитанное число;
+    // меньше max_count - только в конце данных
+    size_t Read(Type* dest, size_t max_count) {
+        size_t done = 0;
+        while (done < max_count) {
+            const size_t available = NextChunkSize();
+            if (available == 0) {
+                break;
+            }
+            const size_t count = std::min(available, max_count - done);
+            ReadExactly(dest + done, count);
+            done += count;
+        }
+        return done;
+    }
+
+    // Заменяет содержимое chunk следующими не более чем max_count элементами.
+    // Возвращает false, когда данные закончились
+    template <typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+    bool ReadChunk(SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& chunk, size_t max_count) {
+        chunk.Clear();
+        const size_t count = std::min(NextChunkSize(), max_count);
+        chunk.AppendWith(count, [this](Type* dest, size_t n) {
+            ReadExactly(dest, n);
+        });
+        return count > 0;
+    }
+
+private:
+    void ReadRaw(void* data, size_t size) {
+        if (!in_.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+            throw SerializationError("unexpected end of stream");
+        }
+    }
+
+    void Finish() {
+        finished_ = true;
+        std::uint64_t checksum;
+        ReadRaw(&checksum, sizeof(checksum));
+        if (checksum != checksum_.Finish()) {
+            throw SerializationError("checksum mismatch");
+        }
+        if (declared_count_ != SerializedVectorHeader::kUnknownCount && read_ != declared_count_) {
+            throw SerializationError("element count does not match the header");
+        }
+    }
+
+    std::istream& in_;
+    std::uint64_t declared_count_ = 0;
+    std::uint64_t chunk_left_ = 0;
+    std::uint64_t read_ = 0;
+    bool finished_ = false;
+    VectorChecksum checksum_;
+};
+
+// Записывает вектор в поток одним куском
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+void Serialize(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v, std::ostream& out) {
+    VectorStreamWriter<Type> writer(out, v.GetSize());
+    writer.Write(v);
+    writer.Finish();
+}
+
+namespace serialization_detail {
+
+// Столько байтов Deserialize резервирует заранее, если длину потока узнать нельзя,
+// и столько читает за один раз: испорченный заголовок не вызывает огромного выделения
+constexpr size_t kReadSliceBytes = size_t(16) << 20;
+
+// Сколько байтов осталось в потоке, или kReadSliceBytes, если поток нельзя перемотать
+inline std::uint64_t ReserveLimit(std::istream& in) {
+    const std::istream::pos_type position = in.tellg();
+    if (position == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+        in.clear();
+        return kReadSliceBytes;
+    }
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(position);
+    if (end == std::istream::pos_type(-1) || !in) {
+        in.clear();
+        in.seekg(position);
+        return kReadSliceBytes;
+    }
+    return static_cast<std::uint64_t>(end - position);
+}
+
+}  // namespace serialization_detail
+
+// Читает вектор, записанный Serialize или VectorStreamWriter. Если число элементов
+// объявлено в заголовке, память выделяется один раз, но не больше, чем под данные,
+// оставшиеся в потоке (или kReadSliceBytes для неперематываемого потока); дальше
+// вектор растёт по мере чтения. Кусок длиннее объявленного остатка - ошибка формата
+template <typename Type, typename Alloc = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth,
+          typename StatsPolicy = NoStats>
+SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy> Deserialize(std::istream& in, const Alloc& alloc = Alloc()) {
+    VectorStreamReader<Type> reader(in);
+    SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy> result(alloc);
+    const std::uint64_t declared = reader.GetDeclaredCount();
+    if (declared != SerializedVectorHeader::kUnknownCount) {
+        if (declared > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw SerializationError("corrupted element count");
+        }
+        const std::uint64_t limit = serialization_detail::ReserveLimit(in) / sizeof(Type);
+        result.Reserve(static_cast<size_t>(std::min(declared, limit)));
+    }
+    constexpr size_t kSlice = std::max<size_t>(serialization_detail::kReadSliceBytes / sizeof(Type), 1);
+    while (const size_t count = reader.NextChunkSize()) {
+        result.AppendWith(std::min(count, kSlice), [&reader](Type* dest, size_t n) {
+            reader.ReadExactly(dest, n);
+        });
+    }
+    return result;
+}
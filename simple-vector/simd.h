@@ -0,0 +1,498 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+
+// Векторизованные ядра сравнения и поиска для массивов арифметических типов.
+// На x86 с GCC ядра собраны в двух вариантах, SSE4.2 и AVX2, и нужный выбирается
+// во время выполнения по возможностям процессора. Везде остальное работает скалярный вариант.
+// Семантика ядер совпадает со стандартными алгоритмами, включая NaN:
+// FindFirstNotEqual ищет первый i с !(a[i] == b[i]), как std::equal,
+// FindFirstDifferent - первый i с a[i] < b[i] || b[i] < a[i], как std::lexicographical_compare
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(__clang__)
+#define SIMPLE_VECTOR_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+// Побитовые операции над массивами 64-битных слов: dst[i] = dst[i] op src[i]
+enum class BitOp {
+    kAnd,
+    kOr,
+    kXor,
+    kAndNot,  // dst[i] & ~src[i]
+};
+
+// Число полос в упакованных блоках UnpackLanes: значение i лежит в полосе i % 4
+inline constexpr size_t kPackLanes = 4;
+
+// Типы, для которых есть векторизованные ядра
+template <typename T>
+inline constexpr bool kIsVectorizable =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Типы, для которых векторизованы MinValue и MaxValue
+template <typename T>
+inline constexpr bool kHasVectorMinMax = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 4;
+
+namespace scalar {
+
+template <typename T>
+size_t FindFirstNotEqual(const T* a, const T* b, size_t n) noexcept {
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+template <typename T>
+size_t FindFirstDifferent(const T* a, const T* b, size_t n) noexcept {
+    size_t i = 0;
+    while (i < n && !(a[i] < b[i]) && !(b[i] < a[i])) {
+        ++i;
+    }
+    return i;
+}
+
+template <typename T>
+size_t Find(const T* data, size_t n, T value) noexcept {
+    return std::find(data, data + n, value) - data;
+}
+
+template <typename T>
+size_t Count(const T* data, size_t n, T value) noexcept {
+    return std::count(data, data + n, value);
+}
+
+template <typename T>
+T MinValue(const T* data, size_t n) noexcept {
+    return *std::min_element(data, data + n);
+}
+
+template <typename T>
+T MaxValue(const T* data, size_t n) noexcept {
+    return *std::max_element(data, data + n);
+}
+
+template <BitOp kOp>
+void ApplyBitOp(std::uint64_t* dst, const std::uint64_t* src, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (kOp == BitOp::kAnd) {
+            dst[i] &= src[i];
+        } else if constexpr (kOp == BitOp::kOr) {
+            dst[i] |= src[i];
+        } else if constexpr (kOp == BitOp::kXor) {
+            dst[i] ^= src[i];
+        } else {
+            dst[i] &= ~src[i];
+        }
+    }
+}
+
+inline void NotWords(std::uint64_t* dst, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = ~dst[i];
+    }
+}
+
+inline size_t PopCount(const std::uint64_t* data, size_t n) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += __builtin_popcountll(data[i]);
+    }
+    return count;
+}
+
+inline void UnpackLanes(const std::uint64_t* in, unsigned width, size_t rows, const std::uint64_t* base, bool delta,
+                        std::uint64_t* out) noexcept {
+    const std::uint64_t mask = (std::uint64_t(1) << width) - 1;
+    const size_t last = (rows * width + 63) / 64 - 1;
+    std::uint64_t acc[kPackLanes];
+    std::copy(base, base + kPackLanes, acc);
+    for (size_t row = 0; row < rows; ++row) {
+        const size_t bit = row * width;
+        const size_t word = bit / 64;
+        const size_t next = std::min(word + 1, last);
+        const unsigned shift = bit % 64;
+        for (size_t lane = 0; lane < kPackLanes; ++lane) {
+            // Старшая часть значения из следующего слова; если значение в слово
+            // поместилось целиком, её биты лежат выше width и срезаются маской
+            const std::uint64_t value =
+                ((in[word * kPackLanes + lane] >> shift) | ((in[next * kPackLanes + lane] << 1) << (63 - shift))) & mask;
+            acc[lane] = (delta ? acc[lane] : base[lane]) + value;
+            out[row * kPackLanes + lane] = acc[lane];
+        }
+    }
+}
+
+}  // namespace scalar
+
+#ifdef SIMPLE_VECTOR_X86_SIMD
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+namespace sse42 {
+
+using Vec = __m128i;
+constexpr size_t kWidth = 16;
+constexpr unsigned kFullMask = 0xFFFFu;
+
+inline Vec Load(const void* p) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+inline void Store(void* p, Vec v) {
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+}
+
+inline unsigned MoveMask(Vec v) {
+    return static_cast<unsigned>(_mm_movemask_epi8(v));
+}
+
+template <typename T>
+Vec Set1(T value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_castps_si128(_mm_set1_ps(value));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm_castpd_si128(_mm_set1_pd(value));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_set1_epi16(static_cast<short>(value));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm_set1_epi32(static_cast<int>(value));
+    } else {
+        return _mm_set1_epi64x(static_cast<long long>(value));
+    }
+}
+
+// Байты полос, где a == b (для чисел с плавающей точкой - упорядоченно равны)
+template <typename T>
+Vec CmpEq(Vec a, Vec b) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm_cmpeq_epi8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_cmpeq_epi16(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm_cmpeq_epi32(a, b);
+    } else {
+        return _mm_cmpeq_epi64(a, b);
+    }
+}
+
+// Байты полос, где a < b || b < a
+template <typename T>
+Vec CmpLessOrGreater(Vec a, Vec b) {
+    if constexpr (std::is_same_v<T, float>) {
+        const __m128 x = _mm_castsi128_ps(a);
+        const __m128 y = _mm_castsi128_ps(b);
+        return _mm_castps_si128(_mm_or_ps(_mm_cmplt_ps(x, y), _mm_cmpgt_ps(x, y)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        const __m128d x = _mm_castsi128_pd(a);
+        const __m128d y = _mm_castsi128_pd(b);
+        return _mm_castpd_si128(_mm_or_pd(_mm_cmplt_pd(x, y), _mm_cmpgt_pd(x, y)));
+    } else {
+        return _mm_xor_si128(CmpEq<T>(a, b), _mm_set1_epi8(-1));
+    }
+}
+
+template <BitOp kOp>
+Vec Apply(Vec a, Vec b) {
+    if constexpr (kOp == BitOp::kAnd) {
+        return _mm_and_si128(a, b);
+    } else if constexpr (kOp == BitOp::kOr) {
+        return _mm_or_si128(a, b);
+    } else if constexpr (kOp == BitOp::kXor) {
+        return _mm_xor_si128(a, b);
+    } else {
+        return _mm_andnot_si128(b, a);
+    }
+}
+
+template <typename T>
+Vec Min(Vec a, Vec b) {
+    if constexpr (sizeof(T) == 1) {
+        return std::is_signed_v<T> ? _mm_min_epi8(a, b) : _mm_min_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return std::is_signed_v<T> ? _mm_min_epi16(a, b) : _mm_min_epu16(a, b);
+    } else {
+        return std::is_signed_v<T> ? _mm_min_epi32(a, b) : _mm_min_epu32(a, b);
+    }
+}
+
+template <typename T>
+Vec Max(Vec a, Vec b) {
+    if constexpr (sizeof(T) == 1) {
+        return std::is_signed_v<T> ? _mm_max_epi8(a, b) : _mm_max_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return std::is_signed_v<T> ? _mm_max_epi16(a, b) : _mm_max_epu16(a, b);
+    } else {
+        return std::is_signed_v<T> ? _mm_max_epi32(a, b) : _mm_max_epu32(a, b);
+    }
+}
+
+inline Vec Add64(Vec a, Vec b) {
+    return _mm_add_epi64(a, b);
+}
+
+inline Vec ShiftRight64(Vec v, unsigned count) {
+    return _mm_srl_epi64(v, _mm_cvtsi32_si128(static_cast<int>(count)));
+}
+
+inline Vec ShiftLeft64(Vec v, unsigned count) {
+    return _mm_sll_epi64(v, _mm_cvtsi32_si128(static_cast<int>(count)));
+}
+
+#include "simd_kernels.inc"
+
+}  // namespace sse42
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+namespace avx2 {
+
+using Vec = __m256i;
+constexpr size_t kWidth = 32;
+constexpr unsigned kFullMask = 0xFFFFFFFFu;
+
+inline Vec Load(const void* p) {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+inline void Store(void* p, Vec v) {
+    _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+}
+
+inline unsigned MoveMask(Vec v) {
+    return static_cast<unsigned>(_mm256_movemask_epi8(v));
+}
+
+template <typename T>
+Vec Set1(T value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_set1_ps(value));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_set1_pd(value));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm256_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm256_set1_epi16(static_cast<short>(value));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_set1_epi32(static_cast<int>(value));
+    } else {
+        return _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+}
+
+// Байты полос, где a == b (для чисел с плавающей точкой - упорядоченно равны)
+template <typename T>
+Vec CmpEq(Vec a, Vec b) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm256_cmpeq_epi8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm256_cmpeq_epi16(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_cmpeq_epi32(a, b);
+    } else {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+}
+
+// Байты полос, где a < b || b < a
+template <typename T>
+Vec CmpLessOrGreater(Vec a, Vec b) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_NEQ_OQ));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_NEQ_OQ));
+    } else {
+        return _mm256_xor_si256(CmpEq<T>(a, b), _mm256_set1_epi8(-1));
+    }
+}
+
+template <BitOp kOp>
+Vec Apply(Vec a, Vec b) {
+    if constexpr (kOp == BitOp::kAnd) {
+        return _mm256_and_si256(a, b);
+    } else if constexpr (kOp == BitOp::kOr) {
+        return _mm256_or_si256(a, b);
+    } else if constexpr (kOp == BitOp::kXor) {
+        return _mm256_xor_si256(a, b);
+    } else {
+        return _mm256_andnot_si256(b, a);
+    }
+}
+
+template <typename T>
+Vec Min(Vec a, Vec b) {
+    if constexpr (sizeof(T) == 1) {
+        return std::is_signed_v<T> ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return std::is_signed_v<T> ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+    } else {
+        return std::is_signed_v<T> ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+    }
+}
+
+template <typename T>
+Vec Max(Vec a, Vec b) {
+    if constexpr (sizeof(T) == 1) {
+        return std::is_signed_v<T> ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return std::is_signed_v<T> ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+    } else {
+        return std::is_signed_v<T> ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+    }
+}
+
+inline Vec Add64(Vec a, Vec b) {
+    return _mm256_add_epi64(a, b);
+}
+
+inline Vec ShiftRight64(Vec v, unsigned count) {
+    return _mm256_srl_epi64(v, _mm_cvtsi32_si128(static_cast<int>(count)));
+}
+
+inline Vec ShiftLeft64(Vec v, unsigned count) {
+    return _mm256_sll_epi64(v, _mm_cvtsi32_si128(static_cast<int>(count)));
+}
+
+#include "simd_kernels.inc"
+
+}  // namespace avx2
+#pragma GCC pop_options
+
+#endif  // SIMPLE_VECTOR_X86_SIMD
+
+enum class Isa {
+    kScalar,
+    kSse42,
+    kAvx2,
+};
+
+// Набор инструкций, выбранный для этого процессора. Определяется один раз
+inline Isa ActiveIsa() noexcept {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+    static const Isa isa = [] {
+        __builtin_cpu_init();
+        // Все процессоры с SSE4.2 и AVX2 умеют popcnt, но проверка ничего не стоит
+        if (!__builtin_cpu_supports("popcnt")) {
+            return Isa::kScalar;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::kAvx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return Isa::kSse42;
+        }
+        return Isa::kScalar;
+    }();
+    return isa;
+#else
+    return Isa::kScalar;
+#endif
+}
+
+#ifdef SIMPLE_VECTOR_X86_SIMD
+#define SIMPLE_VECTOR_SIMD_DISPATCH(kernel, ...)       \
+    switch (ActiveIsa()) {                              \
+    case Isa::kAvx2:                                    \
+        return avx2::kernel(__VA_ARGS__);               \
+    case Isa::kSse42:                                   \
+        return sse42::kernel(__VA_ARGS__);              \
+    default:                                            \
+        return scalar::kernel(__VA_ARGS__);             \
+    }
+#else
+#define SIMPLE_VECTOR_SIMD_DISPATCH(kernel, ...) return scalar::kernel(__VA_ARGS__);
+#endif
+
+// Индекс первого i < n, для которого !(a[i] == b[i]), или n
+template <typename T>
+size_t FindFirstNotEqual(const T* a, const T* b, size_t n) noexcept {
+    static_assert(kIsVectorizable<T>);
+    SIMPLE_VECTOR_SIMD_DISPATCH(FindFirstNotEqual<T>, a, b, n)
+}
+
+// Индекс первого i < n, для которого a[i] < b[i] или b[i] < a[i], или n
+template <typename T>
+size_t FindFirstDifferent(const T* a, const T* b, size_t n) noexcept {
+    static_assert(kIsVectorizable<T>);
+    SIMPLE_VECTOR_SIMD_DISPATCH(FindFirstDifferent<T>, a, b, n)
+}
+
+// Индекс первого элемента, равного value, или n
+template <typename T>
+size_t Find(const T* data, size_t n, T value) noexcept {
+    static_assert(kIsVectorizable<T>);
+    SIMPLE_VECTOR_SIMD_DISPATCH(Find<T>, data, n, value)
+}
+
+// Количество элементов, равных value
+template <typename T>
+size_t Count(const T* data, size_t n, T value) noexcept {
+    static_assert(kIsVectorizable<T>);
+    SIMPLE_VECTOR_SIMD_DISPATCH(Count<T>, data, n, value)
+}
+
+// Наименьший элемент непустого массива
+template <typename T>
+T MinValue(const T* data, size_t n) noexcept {
+    if constexpr (kHasVectorMinMax<T>) {
+        SIMPLE_VECTOR_SIMD_DISPATCH(MinValue<T>, data, n)
+    } else {
+        return scalar::MinValue(data, n);
+    }
+}
+
+// Наибольший элемент непустого массива
+template <typename T>
+T MaxValue(const T* data, size_t n) noexcept {
+    if constexpr (kHasVectorMinMax<T>) {
+        SIMPLE_VECTOR_SIMD_DISPATCH(MaxValue<T>, data, n)
+    } else {
+        return scalar::MaxValue(data, n);
+    }
+}
+
+// Применяет kOp к словам dst и src: dst[i] = dst[i] op src[i]
+template <BitOp kOp>
+void ApplyBitOp(std::uint64_t* dst, const std::uint64_t* src, size_t n) noexcept {
+    SIMPLE_VECTOR_SIMD_DISPATCH(ApplyBitOp<kOp>, dst, src, n)
+}
+
+// Инвертирует слова dst
+inline void NotWords(std::uint64_t* dst, size_t n) noexcept {
+    SIMPLE_VECTOR_SIMD_DISPATCH(NotWords, dst, n)
+}
+
+// Количество единичных битов в словах data
+inline size_t PopCount(const std::uint64_t* data, size_t n) noexcept {
+    SIMPLE_VECTOR_SIMD_DISPATCH(PopCount, data, n)
+}
+
+// Распаковывает rows строк по kPackLanes значений шириной width битов, 0 < width < 64.
+// Полосы упакованы независимо: слово k полосы lane лежит в in[k * kPackLanes + lane].
+// Результат out[row * kPackLanes + lane] - это base[lane] плюс распакованное значение,
+// а при delta - base[lane] плюс сумма значений полосы по строку row включительно
+inline void UnpackLanes(const std::uint64_t* in, unsigned width, size_t rows, const std::uint64_t* base, bool delta,
+                        std::uint64_t* out) noexcept {
+    SIMPLE_VECTOR_SIMD_DISPATCH(UnpackLanes, in, width, rows, base, delta, out)
+}
+
+#undef SIMPLE_VECTOR_SIMD_DISPATCH
+
+}  // namespace simd
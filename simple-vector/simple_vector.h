@@ -1,10 +1,21 @@
 #pragma once
 #include <cassert>
+#include <cstring>
 #include <initializer_list>
+#include <iterator>
 #include <algorithm>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
 #include "array_ptr.h"
+#include "growth_policy.h"
+#include "simd.h"
+#include "vector_stats.h"
 #include <utility>
+#if __has_include(<compare>)
+#include <compare>
+#endif
 
 class ReserveProxyObj{
 public:
@@ -17,56 +28,211 @@ private:
 
 };
 
+// Объекты типа можно переносить побайтовым копированием памяти: копия байтов
+// становится полноценным объектом, а исходный объект после этого не разрушается.
+// По умолчанию верно для тривиально копируемых типов. Для собственных типов-дескрипторов
+// (например, похожих на std::unique_ptr) шаблон можно специализировать
 template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {
+};
+
+template <typename Type>
+struct IsTriviallyRelocatable<std::unique_ptr<Type>> : std::true_type {
+};
+
+template <typename Type>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<Type>::value;
+
+// Итераторные помощники для диапазонных конструкторов и методов
+template <typename It>
+using EnableIfInputIterator = std::enable_if_t<
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>>;
+
+template <typename It>
+inline constexpr bool IsForwardIterator =
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+// Аллокатор определяет собственный construct, и создавать элементы в обход него нельзя
+template <typename Alloc, typename Type, typename = void>
+struct HasCustomConstruct : std::false_type {
+};
+
+template <typename Alloc, typename Type>
+struct HasCustomConstruct<Alloc, Type,
+                          std::void_t<decltype(std::declval<Alloc&>().construct(std::declval<Type*>(),
+                                                                                std::declval<const Type&>()))>>
+    : std::true_type {
+};
+
+// Ленивое поэлементное выражение из vector_expr.h: тип с вложенным типом IsVectorExpression,
+// методами GetSize() и operator[](size_t). Вектор вычисляет его функцией EvaluateInto,
+// найденной поиском по аргументам
+template <typename T, typename = void>
+struct IsVectorExpression : std::false_type {
+};
+
+template <typename T>
+struct IsVectorExpression<T, std::void_t<typename T::IsVectorExpression>> : std::true_type {
+};
+
+template <typename T>
+inline constexpr bool IsVectorExpressionV = IsVectorExpression<T>::value;
+
+// Элементы живут только в диапазоне [0, size_) буфера s_vector_,
+// ячейки [size_, GetCapacity()) остаются неинициализированной памятью.
+// Память выделяется, а элементы создаются и разрушаются через
+// std::allocator_traits<Alloc>. Вместимость при нехватке места увеличивается
+// по политике GrowthPolicy (см. growth_policy.h). О выделениях и переносах памяти
+// сообщается политике StatsPolicy (см. vector_stats.h), по умолчанию ничего не собирающей
+template <typename Type, typename Alloc = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth,
+          typename StatsPolicy = NoStats>
 class SimpleVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Storage = ArrayPtr<Type, Alloc>;
+
 public:
     using Iterator = Type*;
     using ConstIterator = const Type*;
+    using allocator_type = Alloc;
+    // Освобождает чужой буфер: deleter(context, data, capacity)
+    using Deleter = typename Storage::Deleter;
+
+    // Буфер, отданный вектором через Release. Элементы [data, data + size) живы:
+    // получатель разрушает их и освобождает память через Free или снова передаёт
+    // буфер в Adopt вместе с deleter и context. Пустой deleter означает память
+    // аллокатора вектора
+    struct ReleasedBuffer {
+        Type* data = nullptr;
+        size_t size = 0;
+        size_t capacity = 0;
+        Deleter deleter = nullptr;
+        void* context = nullptr;
+
+        // Освобождает память, элементы уже должны быть разрушены. Память аллокатора
+        // возвращается alloc, который должен быть равен аллокатору отдавшего вектора
+        void Free(Alloc alloc = Alloc()) noexcept {
+            if (data == nullptr) {
+                return;
+            }
+            if (deleter != nullptr) {
+                deleter(context, data, capacity);
+            } else {
+                AllocTraits::deallocate(alloc, data, capacity);
+            }
+            data = nullptr;
+        }
+    };
 
-    SimpleVector() noexcept = default;
+    SimpleVector() noexcept(noexcept(Alloc())) = default;
+
+    explicit SimpleVector(const Alloc& alloc) noexcept: s_vector_(alloc) {
+    }
 
     // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size): s_vector_(size), size_(size), capacity_(size) {
-        for (size_t i = 0; i < size; i++){
-            s_vector_[i] = 0;
+    explicit SimpleVector(size_t size, const Alloc& alloc = Alloc()): s_vector_(AllocateStorage(size, alloc)) {
+        try {
+            ConstructBackN(size);
+        } catch (...) {
+            ReportRelease();
+            throw;
         }
     }
 
     // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type& value): s_vector_(size), size_(size), capacity_(size) {
-        for (size_t i = 0; i < size; i++){
-            s_vector_[i] = value;
+    SimpleVector(size_t size, const Type& value, const Alloc& alloc = Alloc()): s_vector_(AllocateStorage(size, alloc)) {
+        try {
+            ConstructBackN(size, value);
+        } catch (...) {
+            ReportRelease();
+            throw;
         }
     }
 
     // Создаёт вектор из std::initializer_list
-    SimpleVector(std::initializer_list<Type> init): s_vector_(init.size()), size_(init.size()), capacity_(init.size()) {
-         std::copy(init.begin(), init.end(), begin());
+    SimpleVector(std::initializer_list<Type> init, const Alloc& alloc = Alloc()): s_vector_(AllocateStorage(init.size(), alloc)) {
+        try {
+            UninitializedCopyN(init.begin(), init.size(), s_vector_.Get());
+        } catch (...) {
+            ReportRelease();
+            throw;
+        }
+        size_ = init.size();
     }
 
+    // Создаёт вектор из копий элементов [first, last)
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    SimpleVector(InputIt first, InputIt last, const Alloc& alloc = Alloc()): s_vector_(alloc) {
+        try {
+            Append(first, last);
+        } catch (...) {
+            ReportRelease();
+            Clear();
+            throw;
+        }
+    }
+
+    SimpleVector(const SimpleVector& other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.get_allocator())) {
+    }
+
+    SimpleVector(const SimpleVector& other, const Alloc& alloc): s_vector_(AllocateStorage(other.size_, alloc)) {
+        try {
+            UninitializedCopyN(other.begin(), other.size_, s_vector_.Get());
+        } catch (...) {
+            ReportRelease();
+            throw;
+        }
+        size_ = other.size_;
+    }
+
+    SimpleVector(SimpleVector&& other) noexcept
+        : s_vector_(std::move(other.s_vector_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Забирает буфер other, если аллокаторы равны, иначе перемещает элементы по одному
+    SimpleVector(SimpleVector&& other, const Alloc& alloc): s_vector_(alloc) {
+        if (alloc == other.get_allocator()) {
+            s_vector_.swap(other.s_vector_);
+            std::swap(size_, other.size_);
+        } else {
+            Storage tmp = AllocateStorage(other.size_, alloc);
+            try {
+                UninitializedCopyN(std::make_move_iterator(other.begin()), other.size_, tmp.Get());
+            } catch (...) {
+                ReportDiscarded(tmp);
+                throw;
+            }
+            s_vector_.swap(tmp);
+            size_ = other.size_;
+        }
+    }
 
-    SimpleVector(const SimpleVector& other) {
-           SimpleVector tmp(other.size_);
-           std::copy(other.begin(), other.end(), tmp.begin());
-           tmp.size_ = other.size_;
-           tmp.capacity_ = other.capacity_;
-           swap(tmp);
-       }
+    SimpleVector(ReserveProxyObj Rpo, const Alloc& alloc = Alloc()): s_vector_(AllocateStorage(Rpo.GetRes(), alloc)) {
+    }
 
-    SimpleVector(SimpleVector&& other) {
-          capacity_ = std::move(other.capacity_);
-          size_ =std::move(other.size_);
-          swap(other);
-          other.size_ =0;
-       }
+    // Вычисляет выражение (см. vector_expr.h) за один проход сразу в память вектора
+    template <typename Expr, typename = std::enable_if_t<IsVectorExpressionV<Expr>>>
+    SimpleVector(const Expr& expr, const Alloc& alloc = Alloc()): s_vector_(AllocateStorage(expr.GetSize(), alloc)) {
+        static_assert(std::is_arithmetic_v<Type>);
+        try {
+            AppendWith(expr.GetSize(), [&expr](Type* first, size_t) {
+                EvaluateInto(expr, first);
+            });
+        } catch (...) {
+            ReportRelease();
+            throw;
+        }
+    }
 
-    SimpleVector(ReserveProxyObj Rpo) {
-           SimpleVector tmp(Rpo.GetRes());
-           tmp.size_ = 0;
-           tmp.capacity_ = Rpo.GetRes();
-           swap(tmp);
-       }
+    ~SimpleVector() {
+        ReportRelease();
+        DestroyN(s_vector_.Get(), size_);
+    }
 
+    allocator_type get_allocator() const noexcept {
+        return s_vector_.GetAllocator();
+    }
 
     // Возвращает количество элементов в массиве
     size_t GetSize() const noexcept {
@@ -75,7 +241,7 @@ public:
 
     // Возвращает вместимость массива
     size_t GetCapacity() const noexcept {
-        return capacity_;
+        return s_vector_.GetSize();
     }
 
     // Сообщает, пустой ли массив
@@ -111,31 +277,98 @@ public:
         } else return s_vector_[index];
     }
 
-    // Обнуляет размер массива, не изменяя его вместимость
-    void Clear() noexcept {
+    // Обнуляет размер массива. Вместимость сохраняется,
+    // если только release_memory не требует вернуть память аллокатору
+    void Clear(bool release_memory = false) noexcept {
+        if (release_memory) {
+            ReportRelease();
+        }
+        DestroyN(s_vector_.Get(), size_);
         size_ = 0;
+        if (release_memory) {
+            s_vector_.Reset();
+        }
+    }
+
+    // Уменьшает вместимость до размера, возвращая лишнюю память аллокатору
+    void ShrinkToFit() {
+        if (size_ == GetCapacity()) {
+            return;
+        }
+        if (size_ == 0) {
+            ReportRelease();
+            s_vector_.Reset();
+            return;
+        }
+        Storage tmp = AllocateStorage(size_, s_vector_.GetAllocator());
+        try {
+            RelocateN(begin(), size_, tmp.Get());
+        } catch (...) {
+            ReportDiscarded(tmp);
+            throw;
+        }
+        DestroyRelocatedN(begin(), size_);
+        ReportRelease();
+        s_vector_.swap(tmp);
+    }
+
+    // Забирает без копирования чужой буфер вместимостью capacity, в котором уже созданы
+    // size элементов. Память потом освобождается вызовом deleter(context, data, capacity);
+    // пустой deleter означает память, выделенную аллокатором вектора.
+    // Прежние элементы разрушаются. При исключении буфер остаётся у вызывающего
+    void Adopt(Type* data, size_t size, size_t capacity, Deleter deleter = nullptr, void* context = nullptr) {
+        assert(size <= capacity);
+        assert(data != nullptr || capacity == 0);
+        Storage tmp(data, capacity, deleter, context, s_vector_.GetAllocator());
+        ReportRelease();
+        DestroyN(s_vector_.Get(), size_);
+        s_vector_.swap(tmp);
+        size_ = size;
+        if (capacity != 0) {
+            StatsPolicy::OnAllocate(capacity, capacity * sizeof(Type));
+        }
+    }
+
+    // То же с произвольной функцией освобождения deleter(data, capacity), например лямбдой
+    // с захватом. Её копия хранится в куче и вызывается один раз
+    template <typename F, typename = std::enable_if_t<!std::is_convertible_v<std::decay_t<F>, Deleter>>>
+    void Adopt(Type* data, size_t size, size_t capacity, F&& deleter) {
+        using Callable = std::decay_t<F>;
+        auto* owned = new Callable(std::forward<F>(deleter));
+        try {
+            Adopt(data, size, capacity, [](void* context, Type* raw_ptr, size_t count) {
+                auto* callable = static_cast<Callable*>(context);
+                (*callable)(raw_ptr, count);
+                delete callable;
+            }, owned);
+        } catch (...) {
+            delete owned;
+            throw;
+        }
+    }
+
+    // Отдаёт буфер вместе с элементами без копирования, вектор остаётся пустым и без памяти
+    [[nodiscard]] ReleasedBuffer Release() noexcept {
+        ReleasedBuffer buffer{s_vector_.Get(), size_, GetCapacity(), s_vector_.GetDeleter(),
+                              s_vector_.GetDeleterContext()};
+        ReportRelease();
+        static_cast<void>(s_vector_.Release());
+        size_ = 0;
+        return buffer;
     }
 
     // Изменяет размер массива.
     // При увеличении размера новые элементы получают значение по умолчанию для типа Type
     void Resize(size_t new_size) {
-        if (new_size<=size_){
+        if (new_size <= size_) {
+            DestroyN(begin() + new_size, size_ - new_size);
             size_ = new_size;
             return;
         }
-        if(capacity_ < new_size) {
-            ArrayPtr<Type> tmp(new_size*2);
-            //std::generate(&tmp[0], &tmp[new_size], Type());
-            std::move(begin(), end(), &tmp[0]);
-            s_vector_.swap(tmp);
-            size_=new_size;
-            capacity_=new_size*2;
-        } else if(new_size>size_){
-                for (Iterator it = end(); it != begin()+new_size; it++){
-                    *it =std::move(Type());
-                }
-                size_ = new_size;
+        if (GetCapacity() < new_size) {
+            Reserve(GrownCapacity(new_size));
         }
+        ConstructBackN(new_size - size_);
     }
 
     // Возвращает итератор на начало массива
@@ -147,7 +380,7 @@ public:
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
     Iterator end() noexcept {
-        return Iterator {&s_vector_[size_]};
+        return Iterator {s_vector_.Get() + size_};
     }
 
     // Возвращает константный итератор на начало массива
@@ -165,193 +398,599 @@ public:
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
     ConstIterator cbegin() const noexcept {
-       return ConstIterator {&s_vector_[0]};
+       return ConstIterator {s_vector_.Get()};
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
     ConstIterator cend() const noexcept {
-      return  ConstIterator {&s_vector_[size_]};
+      return  ConstIterator {s_vector_.Get() + size_};
     }
 
     void Reserve(size_t new_capacity){
-        if (capacity_ == new_capacity){return;}
-        if(capacity_<new_capacity){
-            ReserveProxyObj Rpo(new_capacity);
-            SimpleVector tmp(Rpo);
-            tmp.size_ = size_;
-            std::copy(begin(), end(), tmp.begin());
+        if (new_capacity <= GetCapacity()) {
+            return;
+        }
+        Storage tmp = AllocateStorage(new_capacity, s_vector_.GetAllocator());
+        try {
+            RelocateN(begin(), size_, tmp.Get());
+        } catch (...) {
+            ReportDiscarded(tmp);
+            throw;
+        }
+        DestroyRelocatedN(begin(), size_);
+        ReportRelease();
+        s_vector_.swap(tmp);
+    }
+
+    // Аллокатор rhs перенимается, если это разрешает propagate_on_container_copy_assignment
+    SimpleVector& operator=(const SimpleVector& rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            if (s_vector_.GetAllocator() != rhs.s_vector_.GetAllocator()) {
+                // Старую память может вернуть только старый аллокатор
+                ReportRelease();
+                Clear();
+                s_vector_.Reset();
+            }
+            s_vector_.GetAllocator() = rhs.s_vector_.GetAllocator();
+        }
+        SimpleVector tmp(rhs, s_vector_.GetAllocator());
+        swap(tmp);
+        return *this;
+    }
+
+    // Вычисляет выражение. Если размер не меняется, значения записываются поверх
+    // элементов без выделения памяти: выражение может ссылаться на сам вектор,
+    // потому что элемент i зависит только от элементов i операндов
+    template <typename Expr, typename = std::enable_if_t<IsVectorExpressionV<Expr>>>
+    SimpleVector& operator=(const Expr& expr) {
+        static_assert(std::is_arithmetic_v<Type>);
+        if (expr.GetSize() == size_) {
+            EvaluateInto(expr, begin());
+        } else {
+            SimpleVector tmp(expr, s_vector_.GetAllocator());
             swap(tmp);
         }
+        return *this;
+    }
+
+    // Если аллокатор не распространяется при перемещении и не равен аллокатору rhs,
+    // элементы перемещаются по одному в память собственного аллокатора
+    SimpleVector& operator=(SimpleVector&& rhs) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            ReportRelease();
+            Clear();
+            s_vector_ = std::move(rhs.s_vector_);
+            size_ = std::exchange(rhs.size_, 0);
+        } else {
+            SimpleVector tmp(std::move(rhs), s_vector_.GetAllocator());
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Добавляет элемент в конец вектора
+    // При нехватке места увеличивает вместимость по GrowthPolicy (по умолчанию вдвое)
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент из args прямо в памяти вектора после последнего элемента.
+    // Возвращает ссылку на созданный элемент.
+    // Даёт строгую гарантию безопасности исключений, если Type копируем
+    // или его перемещающий конструктор не бросает исключений
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ < GetCapacity()) {
+            Construct(end(), std::forward<Args>(args)...);
+            ++size_;
+        } else {
+            ReallocateWithGap(GrownCapacity(size_ + 1), size_, 1, [&](Type* gap) {
+                Construct(gap, std::forward<Args>(args)...);
+            });
+        }
+        return *(end() - 1);
+    }
 
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    // Если перед вставкой значения вектор был заполнен полностью, вместимость увеличивается
+    // по GrowthPolicy: по умолчанию вдвое, а для вектора вместимостью 0 становится равной 1
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из args в позиции pos и возвращает итератор на него.
+    // При перераспределении памяти и вставке в конец элемент создаётся сразу на своём месте
+    // со строгой гарантией, как у EmplaceBack. При вставке в середину без перераспределения
+    // элемент сначала создаётся во временном объекте, а затем перемещается на место
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(cbegin() <= pos && cend() >= pos);
+        const size_t index = pos - cbegin();
+        if (size_ == GetCapacity()) {
+            ReallocateWithGap(GrownCapacity(size_ + 1), index, 1, [&](Type* gap) {
+                Construct(gap, std::forward<Args>(args)...);
+            });
+            return begin() + index;
+        }
+        if (index == size_) {
+            Construct(end(), std::forward<Args>(args)...);
+        } else if constexpr (IsTriviallyRelocatableV<Type>) {
+            // Элемент создаётся в сыром буфере до сдвига: args могут ссылаться на сдвигаемые элементы.
+            // Затем хвост сдвигается одним memmove, а элемент переносится на место без деструктора
+            alignas(Type) unsigned char raw[sizeof(Type)];
+            Type* item = reinterpret_cast<Type*>(raw);
+            Construct(item, std::forward<Args>(args)...);
+            std::memmove(static_cast<void*>(begin() + index + 1), static_cast<const void*>(begin() + index),
+                         (size_ - index) * sizeof(Type));
+            std::memcpy(static_cast<void*>(begin() + index), static_cast<const void*>(item), sizeof(Type));
+        } else {
+            // Временный объект нужен и на случай, если args ссылаются на сдвигаемые элементы
+            Type tmp(std::forward<Args>(args)...);
+            Construct(end(), std::move(*(end() - 1)));
+            std::move_backward(begin() + index, end() - 1, end());
+            s_vector_[index] = std::move(tmp);
+        }
+        ++size_;
+        return begin() + index;
     }
 
-       SimpleVector& operator=(const SimpleVector& rhs) {
-           SimpleVector tmp(rhs);
-           swap(tmp);
-           return *this;
-       }
+    // Добавляет в конец копии элементов [first, last).
+    // Для forward-итераторов память перераспределяется не более одного раза.
+    // Диапазон не должен указывать на элементы самого вектора
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        if constexpr (IsForwardIterator<InputIt>) {
+            const size_t count = std::distance(first, last);
+            if (size_ + count > GetCapacity()) {
+                Reserve(GrownCapacity(size_ + count));
+            }
+            UninitializedCopyN(first, count, end());
+            size_ += count;
+        } else {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
 
-       // Добавляет элемент в конец вектора
-       // При нехватке места увеличивает вдвое вместимость вектора
+    // Добавляет в конец count элементов, которые создаёт construct(Type* first, size_t count)
+    // в неинициализированной памяти. construct должен создать ровно count элементов,
+    // а при исключении сам разрушить созданные. Элементы создаются в обход аллокатора,
+    // поэтому метод рассчитан на типы, которым не нужна uses-allocator-конструкция.
+    // Позволяет заполнять память вектора вне его методов, например в нескольких потоках
+    template <typename Construct>
+    void AppendWith(size_t count, Construct&& construct) {
+        if (size_ + count > GetCapacity()) {
+            Reserve(GrownCapacity(size_ + count));
+        }
+        construct(end(), count);
+        size_ += count;
+    }
 
-       void PushBack(const Type& item) {
-           if (capacity_> size_){
-               s_vector_[size_++] = item;
-               return;
-           }
-           if(capacity_ < size_) {
-               ++capacity_ *= 3;
-               ArrayPtr<Type> tmp(capacity_);
-               std::fill(&tmp[0], &tmp[capacity_], Type());
-               std::copy(begin(), end(), &tmp[0]);
-               s_vector_.swap(tmp);
-               s_vector_[size_++] = item;
+    // Вставляет копии элементов [first, last) перед pos и возвращает итератор на первый из них.
+    // Для forward-итераторов память перераспределяется не более одного раза, а хвост
+    // вектора сдвигается один раз: одним memmove для тривиально переносимых типов,
+    // иначе поворотом добавленных в конец элементов на место.
+    // Диапазон не должен указывать на элементы самого вектора
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    Iterator InsertRange(ConstIterator pos, InputIt first, InputIt last) {
+        assert(cbegin() <= pos && cend() >= pos);
+        const size_t index = pos - cbegin();
+        if constexpr (IsForwardIterator<InputIt>) {
+            const size_t count = std::distance(first, last);
+            if (size_ + count > GetCapacity()) {
+                ReallocateWithGap(GrownCapacity(size_ + count), index, count, [&](Type* gap) {
+                    UninitializedCopyN(first, count, gap);
+                });
+                return begin() + index;
+            }
+            if constexpr (IsTriviallyRelocatableV<Type>) {
+                Type* gap = begin() + index;
+                const size_t tail_bytes = (size_ - index) * sizeof(Type);
+                std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), tail_bytes);
+                try {
+                    UninitializedCopyN(first, count, gap);
+                } catch (...) {
+                    std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), tail_bytes);
+                    throw;
+                }
+                size_ += count;
+                return gap;
+            }
+        }
+        const size_t old_size = size_;
+        Append(first, last);
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
+    }
 
-           } else {
-                   std::copy(end(), begin()+(++size_), Type());
-                   s_vector_[size_-1] = item;
-           }}
+    // Удаляет элементы [first, last) и возвращает итератор на элемент, следовавший за ними.
+    // Хвост вектора сдвигается один раз
+    Iterator EraseRange(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        Iterator from = begin() + (first - cbegin());
+        const size_t count = last - first;
+        if (count == 0) {
+            return from;
+        }
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            DestroyN(from, count);
+            std::memmove(static_cast<void*>(from), static_cast<const void*>(from + count),
+                         (end() - from - count) * sizeof(Type));
+        } else {
+            std::move(from + count, end(), from);
+            DestroyN(end() - count, count);
+        }
+        size_ -= count;
+        return from;
+    }
 
-       void PushBack(Type&& item) {
-           if (capacity_>size_ && capacity_ !=0){
-                s_vector_[size_++] = std::move(item);
+    // Заменяет содержимое вектора копиями элементов [first, last).
+    // Для forward-итераторов память перераспределяется не более одного раза;
+    // если новых элементов больше вместимости, даёт строгую гарантию
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void Assign(InputIt first, InputIt last) {
+        if constexpr (IsForwardIterator<InputIt>) {
+            const size_t count = std::distance(first, last);
+            if (count > GetCapacity()) {
+                SimpleVector tmp(first, last, s_vector_.GetAllocator());
+                swap(tmp);
                 return;
-           } else{
-               if (capacity_ == 0) {size_ = 0;}
-               ++capacity_ *= 3;
-
-               ArrayPtr<Type> tmp(capacity_);
-               if(!IsEmpty()){
-                    std::move(begin(), end(), &tmp[0]);
-               }
-
-               tmp[size_++] = std::move(item);
-               s_vector_.swap(tmp);
-               return;
-           }
-}
+            }
+            const size_t common = std::min(count, size_);
+            std::copy_n(first, common, begin());
+            std::advance(first, common);
+            if (count < size_) {
+                DestroyN(begin() + count, size_ - count);
+                size_ = count;
+            } else {
+                UninitializedCopyN(first, count - common, end());
+                size_ = count;
+            }
+        } else {
+            Clear();
+            Append(first, last);
+        }
+    }
+
+    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        AllocTraits::destroy(s_vector_.GetAllocator(), end() - 1);
+        --size_;
+    }
 
-       // Вставляет значение value в позицию pos.
-       // Возвращает итератор на вставленное значение
-       // Если перед вставкой значения вектор был заполнен полностью,
-       // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
-       Iterator Insert(ConstIterator pos, const Type& value) {
-            assert(begin() <= pos && end() >= pos);
-               auto index = std::distance(cbegin(), pos);
-               if (size_== capacity_) {
-                   if(size_) {
-                       ArrayPtr<Type> tmp(size_*=2);
-                       std::copy(begin(), end(), &tmp[0]);
-                       s_vector_.swap(tmp);
-                       size_ = size_;
-                       capacity_ = size_*2;
-                   } else {
-                       ArrayPtr<Type> tmp(++capacity_);
-                       std::copy(begin(), end(), &tmp[0]);
-                       s_vector_.swap(tmp);
-                       capacity_ =1;
-                   }
-               }
-               for (size_t i = size_; i > (size_t)index; --i) {
-                   s_vector_[i] = s_vector_[i-1];
-               }
-               ++size_;
-               s_vector_[index] = value;
-               return const_cast<Iterator>(index +begin());
-
-       }
-
-
-
-       Iterator Insert(ConstIterator pos, Type&& value) {
-            assert(begin() <= pos && end() >= pos);
-                  if (!capacity_) {
-                      ArrayPtr<Type> tmp(++capacity_);
-                      std::move(begin(), end(), &tmp[0]);
-                      s_vector_.swap(tmp);
-                      s_vector_[size_++] = std::move(value);
-                      return begin();
-                  } else if (capacity_ < size_ || capacity_ == size_) {
-                      auto index = std::distance(begin(), const_cast<Iterator>(pos));
-                      ArrayPtr<Type> tmp(capacity_*=2);
-                      std::move(begin(), end(), &tmp[0]);
-                      std::copy_backward(std::make_move_iterator(const_cast<Iterator>(pos)), std::make_move_iterator(begin()+size_), (&tmp[1 + size_]));
-                      tmp[index] = std::move(value);
-                      ++size_;
-                      s_vector_.swap(tmp);
-                      return Iterator(&s_vector_[index]);
-                  } else {
-                      std::copy_backward(std::make_move_iterator(const_cast<Iterator>(pos)), std::make_move_iterator(end()), (&s_vector_[++size_+1]));
-                      *const_cast<Iterator>(pos) = std::move(value);
-                      return const_cast<Iterator>(pos);
-                  }
-          }
-
-
-       // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
-       void PopBack() noexcept {
-           assert(!IsEmpty());
-               size_--;
-       }
-
-       // Удаляет элемент вектора в указанной позиции
-       Iterator Erase(ConstIterator pos) {
-           assert(!IsEmpty());
-           assert(begin() <= pos && end() >= pos);
-           Iterator pos_no_const = const_cast<Iterator>(pos);
-           std::move(pos_no_const + 1, end(), pos_no_const);
-           size_--;
-           return pos_no_const;
-       }
-
-       // Обменивает значение с другим вектором
-       void swap(SimpleVector& other) noexcept {
-           s_vector_.swap(other.s_vector_);
-           std::swap(size_, other.size_);
-           std::swap(capacity_, other.capacity_);
-       }
+    // Удаляет элемент вектора в указанной позиции
+    Iterator Erase(ConstIterator pos) {
+        assert(!IsEmpty());
+        assert(begin() <= pos && end() > pos);
+        Iterator pos_no_const = begin() + (pos - cbegin());
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            AllocTraits::destroy(s_vector_.GetAllocator(), pos_no_const);
+            std::memmove(static_cast<void*>(pos_no_const), static_cast<const void*>(pos_no_const + 1),
+                         (end() - pos_no_const - 1) * sizeof(Type));
+            --size_;
+        } else {
+            std::move(pos_no_const + 1, end(), pos_no_const);
+            PopBack();
+        }
+        return pos_no_const;
+    }
+
+    // Обменивает значение с другим вектором.
+    // Аллокаторы обмениваются, только если это разрешает propagate_on_container_swap,
+    // иначе они должны быть равны
+    void swap(SimpleVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            s_vector_.SwapWithAllocator(other.s_vector_);
+        } else {
+            s_vector_.swap(other.s_vector_);
+        }
+        std::swap(size_, other.size_);
+    }
 
 private:
-    ArrayPtr<Type> s_vector_;
+    // Вместимость после очередного увеличения по GrowthPolicy, но не меньше required
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::Next(GetCapacity(), sizeof(Type)), required);
+    }
+
+    template <typename... Args>
+    void Construct(Type* place, Args&&... args) {
+        AllocTraits::construct(s_vector_.GetAllocator(), place, std::forward<Args>(args)...);
+    }
+
+    void DestroyN(Type* first, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            AllocTraits::destroy(s_vector_.GetAllocator(), first + i);
+        }
+    }
+
+    // Создаёт count элементов из args в свободной памяти после end().
+    // При исключении уже созданные элементы разрушаются, размер не меняется
+    template <typename... Args>
+    void ConstructBackN(size_t count, const Args&... args) {
+        const size_t old_size = size_;
+        try {
+            for (; size_ < old_size + count; ++size_) {
+                Construct(end(), args...);
+            }
+        } catch (...) {
+            DestroyN(begin() + old_size, size_ - old_size);
+            size_ = old_size;
+            throw;
+        }
+    }
+
+    // Стандартные аллокаторы и аллокаторы без собственного construct создают объекты
+    // обычным placement new, поэтому тривиально копируемые элементы можно копировать побайтово
+    static constexpr bool kConstructsInPlace = std::is_same_v<Alloc, std::allocator<Type>>
+                                               || std::is_same_v<Alloc, std::pmr::polymorphic_allocator<Type>>
+                                               || !HasCustomConstruct<Alloc, Type>::value;
+
+    // Создаёт в неинициализированной памяти to копии count элементов from.
+    // При исключении уже созданные копии разрушаются
+    template <typename InputIt>
+    void UninitializedCopyN(InputIt from, size_t count, Type* to) {
+        if constexpr (kConstructsInPlace && std::is_trivially_copyable_v<Type> && std::is_pointer_v<InputIt>
+                      && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, Type>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+            }
+            return;
+        }
+        size_t done = 0;
+        try {
+            for (; done < count; ++done, ++from) {
+                Construct(to + done, *from);
+            }
+        } catch (...) {
+            DestroyN(to, done);
+            throw;
+        }
+    }
+
+    static Storage AllocateStorage(size_t capacity, const Alloc& alloc) {
+        Storage storage(capacity, alloc);
+        if (capacity != 0) {
+            StatsPolicy::OnAllocate(capacity, capacity * sizeof(Type));
+        }
+        return storage;
+    }
+
+    // Сообщает StatsPolicy, что текущий буфер вот-вот будет освобождён
+    void ReportRelease() const noexcept {
+        if (s_vector_) {
+            StatsPolicy::OnRelease(GetCapacity(), size_);
+        }
+    }
+
+    // Сообщает StatsPolicy об освобождении нового буфера, который не удалось заполнить
+    static void ReportDiscarded(const Storage& storage) noexcept {
+        if (storage) {
+            StatsPolicy::OnRelease(storage.GetSize(), 0);
+        }
+    }
+
+    // Переносит элементы в новый буфер вместимостью new_capacity, оставляя перед элементом
+    // с индексом index промежуток из count ячеек, который заполняет construct_gap(Type* gap).
+    // construct_gap вызывается до переноса, поэтому его аргументы могут ссылаться на элементы
+    // вектора; при исключении он сам разрушает то, что успел создать.
+    // Размер вектора увеличивается на count
+    template <typename ConstructGap>
+    void ReallocateWithGap(size_t new_capacity, size_t index, size_t count, ConstructGap&& construct_gap) {
+        Storage tmp = AllocateStorage(new_capacity, s_vector_.GetAllocator());
+        try {
+            construct_gap(tmp.Get() + index);
+        } catch (...) {
+            ReportDiscarded(tmp);
+            throw;
+        }
+        try {
+            RelocateN(begin(), index, tmp.Get());
+        } catch (...) {
+            DestroyN(tmp.Get() + index, count);
+            ReportDiscarded(tmp);
+            throw;
+        }
+        try {
+            RelocateN(begin() + index, size_ - index, tmp.Get() + index + count);
+        } catch (...) {
+            DestroyN(tmp.Get(), index + count);
+            ReportDiscarded(tmp);
+            throw;
+        }
+        DestroyRelocatedN(begin(), size_);
+        ReportRelease();
+        s_vector_.swap(tmp);
+        size_ += count;
+    }
+
+    // Создаёт в неинициализированной памяти to перенесённые копии count элементов from.
+    // Тривиально переносимые элементы копируются одним memcpy. Остальные, как и
+    // std::move_if_noexcept, перемещаются, если перемещение не бросает исключений
+    // или копирование невозможно, иначе копируются, чтобы при исключении
+    // исходные элементы остались нетронутыми.
+    // После успешного переноса исходные элементы освобождает DestroyRelocatedN
+    void RelocateN(Iterator from, size_t count, Type* to) {
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+            }
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < count; ++done) {
+                    Construct(to + done, std::move_if_noexcept(from[done]));
+                }
+            } catch (...) {
+                DestroyN(to, done);
+                throw;
+            }
+        }
+        constexpr bool kMoves = IsTriviallyRelocatableV<Type> || std::is_nothrow_move_constructible_v<Type>
+                                || !std::is_copy_constructible_v<Type>;
+        StatsPolicy::OnRelocate(kMoves ? count : 0, kMoves ? 0 : count, count * sizeof(Type));
+    }
+
+    // Разрушает исходные элементы после RelocateN. Побайтово перенесённые
+    // объекты теперь живут в новой памяти, поэтому их деструкторы не вызываются
+    void DestroyRelocatedN(Iterator first, size_t count) noexcept {
+        if constexpr (!IsTriviallyRelocatableV<Type>) {
+            DestroyN(first, count);
+        }
+    }
+
+    Storage s_vector_;
     size_t size_= 0;
-    size_t capacity_= 0;
 };
 
+namespace pmr {
 
+// SimpleVector, берущий память у std::pmr::memory_resource
+template <typename Type, typename GrowthPolicy = DoublingGrowth, typename StatsPolicy = NoStats>
+using SimpleVector = ::SimpleVector<Type, std::pmr::polymorphic_allocator<Type>, GrowthPolicy, StatsPolicy>;
 
+}  // namespace pmr
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+
+
+
+inline ReserveProxyObj Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObj(capacity_to_reserve);
 }
 
+namespace vector_compare {
+
+// Первый индекс, где элементы равной длины count различаются: для арифметических типов
+// ищется векторизованными ядрами из simd.h, для остальных - обычным циклом
 template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs.GetSize() == rhs.GetSize()) && std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()) ;
+size_t FindFirstNotEqual(const Type* lhs, const Type* rhs, size_t count) {
+    if constexpr (simd::kIsVectorizable<Type>) {
+        return simd::FindFirstNotEqual(lhs, rhs, count);
+    } else {
+        return std::mismatch(lhs, lhs + count, rhs).first - lhs;
+    }
 }
 
+// Лексикографическое сравнение за один проход: отрицательное число, если lhs < rhs,
+// положительное, если rhs < lhs, и 0, если ни то, ни другое. Элементам нужен только operator<
 template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+int Compare(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    const size_t common = std::min(lhs_size, rhs_size);
+    size_t i = 0;
+    if constexpr (simd::kIsVectorizable<Type>) {
+        i = simd::FindFirstDifferent(lhs, rhs, common);
+    } else {
+        while (i < common && !(lhs[i] < rhs[i]) && !(rhs[i] < lhs[i])) {
+            ++i;
+        }
+    }
+    if (i < common) {
+        return lhs[i] < rhs[i] ? -1 : 1;
+    }
+    return lhs_size < rhs_size ? -1 : (rhs_size < lhs_size ? 1 : 0);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+int Compare(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return Compare(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+}  // namespace vector_compare
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline bool operator==(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return lhs.GetSize() == rhs.GetSize()
+           && vector_compare::FindFirstNotEqual(lhs.begin(), rhs.begin(), lhs.GetSize()) == lhs.GetSize();
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline bool operator!=(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(),rhs.begin(), rhs.end());
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline bool operator<(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return vector_compare::Compare(lhs, rhs) < 0;
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs == rhs) || (lhs < rhs);
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline bool operator<=(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return vector_compare::Compare(lhs, rhs) <= 0;
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !(lhs < rhs);
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline bool operator>(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return vector_compare::Compare(lhs, rhs) > 0;
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs == rhs) || (lhs > rhs);
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline bool operator>=(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return vector_compare::Compare(lhs, rhs) >= 0;
+}
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+// Элементы сравниваются только через operator<, поэтому порядок слабый
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+inline std::weak_ordering operator<=>(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& rhs) {
+    return vector_compare::Compare(lhs, rhs) <=> 0;
+}
+#endif
+
+// Поиск по вектору; для арифметических типов работает векторизованными ядрами из simd.h
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+auto Find(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v, const Type& value) {
+    if constexpr (simd::kIsVectorizable<Type>) {
+        return v.begin() + simd::Find(v.begin(), v.GetSize(), value);
+    } else {
+        return std::find(v.begin(), v.end(), value);
+    }
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+size_t Count(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v, const Type& value) {
+    if constexpr (simd::kIsVectorizable<Type>) {
+        return simd::Count(v.begin(), v.GetSize(), value);
+    } else {
+        return std::count(v.begin(), v.end(), value);
+    }
 }
 
+// Итератор на первый наименьший элемент или end() для пустого вектора
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+auto MinElement(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v) {
+    if constexpr (simd::kHasVectorMinMax<Type>) {
+        return v.IsEmpty() ? v.end() : Find(v, simd::MinValue(v.begin(), v.GetSize()));
+    } else {
+        return std::min_element(v.begin(), v.end());
+    }
+}
+
+// Итератор на первый наибольший элемент или end() для пустого вектора
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+auto MaxElement(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& v) {
+    if constexpr (simd::kHasVectorMinMax<Type>) {
+        return v.IsEmpty() ? v.end() : Find(v, simd::MaxValue(v.begin(), v.GetSize()));
+    } else {
+        return std::max_element(v.begin(), v.end());
+    }
+}
@@ -0,0 +1,343 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "simple_vector.h"
+
+template <typename Type>
+class StridedView;
+
+// Невладеющий срез непрерывной памяти: указатель и длина, как std::span.
+// Не копирует элементы и не продлевает им жизнь: срез SimpleVector становится
+// недействительным при любом перераспределении памяти вектора.
+// SimpleVectorView<const Type> разрешает только чтение
+template <typename Type>
+class SimpleVectorView {
+public:
+    using Iterator = Type*;
+    using value_type = std::remove_cv_t<Type>;
+
+    // Значение count для Subview: до конца среза
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    SimpleVectorView() = default;
+
+    SimpleVectorView(Type* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+        assert(data != nullptr || size == 0);
+    }
+
+    template <typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+    SimpleVectorView(SimpleVector<value_type, Alloc, GrowthPolicy, StatsPolicy>& vector) noexcept
+        : data_(vector.begin())
+        , size_(vector.GetSize()) {
+    }
+
+    // Срез константного вектора допускает только чтение
+    template <typename Alloc, typename GrowthPolicy, typename StatsPolicy, typename T = Type,
+              typename = std::enable_if_t<std::is_const_v<T>>>
+    SimpleVectorView(const SimpleVector<value_type, Alloc, GrowthPolicy, StatsPolicy>& vector) noexcept
+        : data_(vector.begin())
+        , size_(vector.GetSize()) {
+    }
+
+    template <typename Other, typename = std::enable_if_t<!std::is_same_v<Other, Type>
+                                                          && std::is_same_v<const Other, Type>>>
+    SimpleVectorView(SimpleVectorView<Other> other) noexcept
+        : data_(other.Data())
+        , size_(other.GetSize()) {
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return data_[index];
+    }
+
+    Iterator begin() const noexcept {
+        return data_;
+    }
+
+    Iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    // Срез из count элементов, начиная с offset; count обрезается по концу среза.
+    // Выбрасывает исключение std::out_of_range, если offset > size
+    SimpleVectorView Subview(size_t offset, size_t count = npos) const {
+        if (offset > size_) {
+            throw std::out_of_range("Subview offset is out of range");
+        }
+        return SimpleVectorView(data_ + offset, std::min(count, size_ - offset));
+    }
+
+    // Первые count элементов. Выбрасывает исключение std::out_of_range, если count > size
+    SimpleVectorView First(size_t count) const {
+        if (count > size_) {
+            throw std::out_of_range("Subview count is out of range");
+        }
+        return SimpleVectorView(data_, count);
+    }
+
+    // Последние count элементов. Выбрасывает исключение std::out_of_range, если count > size
+    SimpleVectorView Last(size_t count) const {
+        if (count > size_) {
+            throw std::out_of_range("Subview count is out of range");
+        }
+        return SimpleVectorView(data_ + size_ - count, count);
+    }
+
+    // Каждый step-й элемент, начиная с первого.
+    // Выбрасывает исключение std::invalid_argument, если step == 0
+    StridedView<Type> Strided(size_t step) const {
+        if (step == 0) {
+            throw std::invalid_argument("Stride must be positive");
+        }
+        return StridedView<Type>(data_, (size_ + step - 1) / step, step);
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+SimpleVectorView(SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>&) -> SimpleVectorView<Type>;
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+SimpleVectorView(const SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>&) -> SimpleVectorView<const Type>;
+
+// Невладеющий срез с шагом: элемент i лежит по адресу data + i * stride.
+// Получается из SimpleVectorView::Strided, например для одного канала
+// в чередующихся отсчётах или одного столбца матрицы, хранящейся по строкам
+template <typename Type>
+class StridedView {
+public:
+    using value_type = std::remove_cv_t<Type>;
+
+    // Итератор произвольного доступа, который шагает на stride элементов
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<Type>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Type*;
+        using reference = Type&;
+
+        Iterator() = default;
+
+        Iterator(Type* data, size_t index, size_t stride) noexcept
+            : data_(data)
+            , index_(static_cast<difference_type>(index))
+            , stride_(static_cast<difference_type>(stride)) {
+        }
+
+        reference operator*() const noexcept {
+            return data_[index_ * stride_];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return data_[(index_ + n) * stride_];
+        }
+
+        Iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        Iterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept {
+            Iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        Iterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it) noexcept {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+            assert(lhs.data_ == rhs.data_);
+            return lhs.index_ - rhs.index_;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        // Адрес data + index * stride за концом среза может лежать дальше конца
+        // памяти, поэтому итератор хранит индекс, а не указатель
+        Type* data_ = nullptr;
+        difference_type index_ = 0;
+        difference_type stride_ = 1;
+    };
+
+    StridedView() = default;
+
+    StridedView(Type* data, size_t size, size_t stride) noexcept
+        : data_(data)
+        , size_(size)
+        , stride_(stride) {
+        assert(stride != 0);
+        assert(data != nullptr || size == 0);
+    }
+
+    template <typename Other, typename = std::enable_if_t<!std::is_same_v<Other, Type>
+                                                          && std::is_same_v<const Other, Type>>>
+    StridedView(StridedView<Other> other) noexcept
+        : data_(other.Data())
+        , size_(other.GetSize())
+        , stride_(other.GetStride()) {
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Шаг между соседними элементами среза в элементах Type
+    size_t GetStride() const noexcept {
+        return stride_;
+    }
+
+    // Адрес первого элемента среза
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index * stride_];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return data_[index * stride_];
+    }
+
+    Iterator begin() const noexcept {
+        return Iterator(data_, 0, stride_);
+    }
+
+    Iterator end() const noexcept {
+        return Iterator(data_, size_, stride_);
+    }
+
+    // Те же правила границ, что у SimpleVectorView, в индексах среза
+    StridedView Subview(size_t offset, size_t count = SimpleVectorView<Type>::npos) const {
+        if (offset > size_) {
+            throw std::out_of_range("Subview offset is out of range");
+        }
+        count = std::min(count, size_ - offset);
+        return StridedView(count != 0 ? data_ + offset * stride_ : data_, count, stride_);
+    }
+
+    StridedView First(size_t count) const {
+        if (count > size_) {
+            throw std::out_of_range("Subview count is out of range");
+        }
+        return StridedView(data_, count, stride_);
+    }
+
+    StridedView Last(size_t count) const {
+        if (count > size_) {
+            throw std::out_of_range("Subview count is out of range");
+        }
+        return StridedView(count != 0 ? data_ + (size_ - count) * stride_ : data_, count, stride_);
+    }
+
+    // Каждый step-й элемент среза
+    StridedView Strided(size_t step) const {
+        if (step == 0) {
+            throw std::invalid_argument("Stride must be positive");
+        }
+        return StridedView(data_, (size_ + step - 1) / step, stride_ * step);
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+    size_t stride_ = 1;
+};
@@ -0,0 +1,418 @@
+#pragma once
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Вектор с тем же интерфейсом, что и SimpleVector, хранящий до N элементов
+// прямо в объекте. Память в куче (через ArrayPtr) выделяется, только когда
+// элементов становится больше N; после этого вектор ведёт себя как SimpleVector
+template <typename Type, size_t N, typename GrowthPolicy = DoublingGrowth>
+class SmallSimpleVector {
+    static_assert(N > 0, "SmallSimpleVector needs inline capacity");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    SmallSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallSimpleVector(size_t size) {
+        Reserve(size);
+        ConstructBackN(size);
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallSimpleVector(size_t size, const Type& value) {
+        Reserve(size);
+        ConstructBackN(size, value);
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SmallSimpleVector(std::initializer_list<Type> init) {
+        Reserve(init.size());
+        std::uninitialized_copy(init.begin(), init.end(), Data());
+        size_ = init.size();
+    }
+
+    SmallSimpleVector(const SmallSimpleVector& other) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    SmallSimpleVector(SmallSimpleVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        TakeFrom(other);
+    }
+
+    SmallSimpleVector(ReserveProxyObj Rpo) {
+        Reserve(Rpo.GetRes());
+    }
+
+    ~SmallSimpleVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    SmallSimpleVector& operator=(const SmallSimpleVector& rhs) {
+        if (this != &rhs) {
+            SmallSimpleVector tmp(rhs);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SmallSimpleVector& operator=(SmallSimpleVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &rhs) {
+            Clear();
+            if (rhs.heap_) {
+                heap_.Reset();
+            }
+            TakeFrom(rhs);
+        }
+        return *this;
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива. Не бывает меньше N
+    size_t GetCapacity() const noexcept {
+        return heap_ ? heap_.GetSize() : N;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return !size_;
+    }
+
+    // Сообщает, хранятся ли элементы внутри объекта
+    bool IsInline() const noexcept {
+        return !heap_;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return Data()[index];
+    }
+
+    // Обнуляет размер массива. Память в куче сохраняется,
+    // если только release_memory не требует вернуть её и перейти на встроенный буфер
+    void Clear(bool release_memory = false) noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+        if (release_memory) {
+            heap_.Reset();
+        }
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            std::destroy(begin() + new_size, end());
+            size_ = new_size;
+            return;
+        }
+        if (GetCapacity() < new_size) {
+            Reserve(GrownCapacity(new_size));
+        }
+        ConstructBackN(new_size - size_);
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return cend();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= GetCapacity()) {
+            return;
+        }
+        ArrayPtr<Type> tmp(new_capacity);
+        RelocateN(begin(), size_, tmp.Get());
+        DestroyRelocatedN(begin(), size_);
+        heap_.swap(tmp);
+    }
+
+    // Уменьшает вместимость до размера. Если элементы помещаются во встроенный буфер,
+    // они переносятся туда, а память в куче освобождается
+    void ShrinkToFit() {
+        if (!heap_ || size_ == GetCapacity()) {
+            return;
+        }
+        if (size_ <= N) {
+            RelocateN(begin(), size_, InlineData());
+            DestroyRelocatedN(begin(), size_);
+            heap_.Reset();
+            return;
+        }
+        ArrayPtr<Type> tmp(size_);
+        RelocateN(begin(), size_, tmp.Get());
+        DestroyRelocatedN(begin(), size_);
+        heap_.swap(tmp);
+    }
+
+    // Добавляет элемент в конец вектора
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент из args прямо в памяти вектора после последнего элемента
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ < GetCapacity()) {
+            new (end()) Type(std::forward<Args>(args)...);
+        } else {
+            // Новый элемент создаётся раньше переноса старых: args могут ссылаться на элементы вектора
+            ArrayPtr<Type> tmp(GrownCapacity(size_ + 1));
+            new (tmp.Get() + size_) Type(std::forward<Args>(args)...);
+            try {
+                RelocateN(begin(), size_, tmp.Get());
+            } catch (...) {
+                std::destroy_at(tmp.Get() + size_);
+                throw;
+            }
+            DestroyRelocatedN(begin(), size_);
+            heap_.swap(tmp);
+        }
+        ++size_;
+        return *(end() - 1);
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из args в позиции pos и возвращает итератор на него
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(cbegin() <= pos && cend() >= pos);
+        const size_t index = pos - cbegin();
+        if (size_ == GetCapacity()) {
+            ArrayPtr<Type> tmp(GrownCapacity(size_ + 1));
+            new (tmp.Get() + index) Type(std::forward<Args>(args)...);
+            try {
+                RelocateN(begin(), index, tmp.Get());
+            } catch (...) {
+                std::destroy_at(tmp.Get() + index);
+                throw;
+            }
+            try {
+                RelocateN(begin() + index, size_ - index, tmp.Get() + index + 1);
+            } catch (...) {
+                std::destroy_n(tmp.Get(), index + 1);
+                throw;
+            }
+            DestroyRelocatedN(begin(), size_);
+            heap_.swap(tmp);
+        } else if (index == size_) {
+            new (end()) Type(std::forward<Args>(args)...);
+        } else {
+            // Временный объект нужен на случай, если args ссылаются на сдвигаемые элементы
+            Type tmp(std::forward<Args>(args)...);
+            new (end()) Type(std::move(*(end() - 1)));
+            std::move_backward(begin() + index, end() - 1, end());
+            Data()[index] = std::move(tmp);
+        }
+        ++size_;
+        return begin() + index;
+    }
+
+    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        std::destroy_at(end() - 1);
+        --size_;
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    Iterator Erase(ConstIterator pos) {
+        assert(!IsEmpty());
+        assert(cbegin() <= pos && cend() > pos);
+        Iterator pos_no_const = begin() + (pos - cbegin());
+        std::move(pos_no_const + 1, end(), pos_no_const);
+        PopBack();
+        return pos_no_const;
+    }
+
+    // Обменивает значение с другим вектором.
+    // Если хотя бы один из векторов хранит элементы внутри себя, они перемещаются
+    void swap(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (heap_ && other.heap_) {
+            heap_.swap(other.heap_);
+            std::swap(size_, other.size_);
+            return;
+        }
+        SmallSimpleVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    Type* InlineData() noexcept {
+        return std::launder(reinterpret_cast<Type*>(inline_));
+    }
+
+    const Type* InlineData() const noexcept {
+        return std::launder(reinterpret_cast<const Type*>(inline_));
+    }
+
+    Type* Data() noexcept {
+        return heap_ ? heap_.Get() : InlineData();
+    }
+
+    const Type* Data() const noexcept {
+        return heap_ ? heap_.Get() : InlineData();
+    }
+
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::Next(GetCapacity(), sizeof(Type)), required);
+    }
+
+    // Забирает содержимое other, когда собственных элементов нет:
+    // буфер в куче переходит целиком, встроенные элементы переносятся по одному
+    void TakeFrom(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        assert(size_ == 0);
+        if (other.heap_) {
+            heap_.swap(other.heap_);
+        } else {
+            std::uninitialized_move_n(other.begin(), other.size_, Data());
+            std::destroy_n(other.begin(), other.size_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    template <typename... Args>
+    void ConstructBackN(size_t count, const Args&... args) {
+        const size_t old_size = size_;
+        try {
+            for (; size_ < old_size + count; ++size_) {
+                new (end()) Type(args...);
+            }
+        } catch (...) {
+            std::destroy(begin() + old_size, end());
+            size_ = old_size;
+            throw;
+        }
+    }
+
+    // Переносит элементы так же, как SimpleVector: одним memcpy для
+    // тривиально переносимых типов, иначе с std::move_if_noexcept
+    static void RelocateN(Iterator from, size_t count, Type* to) {
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+            }
+        } else if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            std::uninitialized_move_n(from, count, to);
+        } else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+    }
+
+    static void DestroyRelocatedN(Iterator first, size_t count) noexcept {
+        if constexpr (!IsTriviallyRelocatableV<Type>) {
+            std::destroy_n(first, count);
+        }
+    }
+
+    alignas(Type) unsigned char inline_[N * sizeof(Type)];
+    ArrayPtr<Type> heap_;
+    size_t size_ = 0;
+};
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator==(const SmallSimpleVector<Type, N, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, GrowthPolicy>& rhs) {
+    return lhs.GetSize() == rhs.GetSize()
+           && vector_compare::FindFirstNotEqual(lhs.begin(), rhs.begin(), lhs.GetSize()) == lhs.GetSize();
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator!=(const SmallSimpleVector<Type, N, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator<(const SmallSimpleVector<Type, N, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, GrowthPolicy>& rhs) {
+    return vector_compare::Compare(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize()) < 0;
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator<=(const SmallSimpleVector<Type, N, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator>(const SmallSimpleVector<Type, N, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator>=(const SmallSimpleVector<Type, N, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,607 @@
+#pragma once
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Непрерывный участок одного столбца SoASimpleVector
+template <typename Type>
+class ColumnSpan {
+public:
+    ColumnSpan(Type* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    Type* begin() const noexcept {
+        return data_;
+    }
+
+    Type* end() const noexcept {
+        return data_ + size_;
+    }
+
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+private:
+    Type* data_;
+    size_t size_;
+};
+
+// Вектор записей, хранящий каждое поле в собственном буфере ArrayPtr (structure of arrays).
+// Цикл по одному полю читает только его столбец и не тянет в кеш остальные поля записи.
+// Все столбцы имеют общие размер и вместимость, вместимость растёт по DoublingGrowth.
+// Строка доступна как std::tuple ссылок на поля: через operator[] и итераторы,
+// которые поддерживают структурные привязки: for (auto [id, price] : v) { ... }.
+// Итераторы - прокси, поэтому алгоритмы, переставляющие элементы (std::sort), с ними не работают.
+// Вставка с перераспределением памяти даёт строгую гарантию: сначала копируются столбцы
+// без noexcept-перемещения, и лишь потом перемещаются остальные
+template <typename... Fields>
+class SoASimpleVector {
+    static_assert(sizeof...(Fields) > 0, "SoASimpleVector needs at least one field");
+
+    using Columns = std::tuple<ArrayPtr<Fields>...>;
+    using Indices = std::index_sequence_for<Fields...>;
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template <bool kConst>
+    class RowIterator {
+        using Owner = std::conditional_t<kConst, const SoASimpleVector, SoASimpleVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::tuple<Fields...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, std::tuple<const Fields&...>, std::tuple<Fields&...>>;
+        using pointer = void;
+
+        RowIterator() = default;
+
+        RowIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор приводится к константному
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        RowIterator(const RowIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*owner_)[index_ + n];
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        RowIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        RowIterator operator++(int) noexcept {
+            RowIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        RowIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        RowIterator operator--(int) noexcept {
+            RowIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        RowIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        RowIterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend RowIterator operator+(RowIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend RowIterator operator+(difference_type n, RowIterator it) noexcept {
+            return it += n;
+        }
+
+        friend RowIterator operator-(RowIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class RowIterator<!kConst>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Iterator = RowIterator<false>;
+    using ConstIterator = RowIterator<true>;
+    using Row = std::tuple<Fields&...>;
+    using ConstRow = std::tuple<const Fields&...>;
+
+    static constexpr size_t kFieldCount = sizeof...(Fields);
+
+    SoASimpleVector() noexcept = default;
+
+    // Создаёт вектор из size записей, поля которых инициализированы по умолчанию
+    explicit SoASimpleVector(size_t size) {
+        Resize(size);
+    }
+
+    SoASimpleVector(ReserveProxyObj obj) {
+        Reserve(obj.GetRes());
+    }
+
+    SoASimpleVector(const SoASimpleVector& other) {
+        Columns fresh = AllocateColumns(other.size_);
+        CopyColumns(other.columns_, fresh, other.size_);
+        columns_ = std::move(fresh);
+        size_ = other.size_;
+        capacity_ = other.size_;
+    }
+
+    SoASimpleVector(SoASimpleVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    SoASimpleVector& operator=(const SoASimpleVector& rhs) {
+        if (this != &rhs) {
+            SoASimpleVector copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SoASimpleVector& operator=(SoASimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            columns_ = std::move(rhs.columns_);
+            size_ = std::exchange(rhs.size_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~SoASimpleVector() {
+        Clear();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Столбец поля с номером I
+    template <size_t I>
+    ColumnSpan<FieldType<I>> Column() noexcept {
+        return {std::get<I>(columns_).Get(), size_};
+    }
+
+    template <size_t I>
+    ColumnSpan<const FieldType<I>> Column() const noexcept {
+        return {std::get<I>(columns_).Get(), size_};
+    }
+
+    // Кортеж ссылок на поля записи с индексом index
+    Row operator[](size_t index) noexcept {
+        assert(index < size_);
+        return RowAt(index, Indices{});
+    }
+
+    ConstRow operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return RowAt(index, Indices{});
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Row At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return RowAt(index, Indices{});
+    }
+
+    ConstRow At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Not-element");
+        }
+        return RowAt(index, Indices{});
+    }
+
+    Iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    Iterator end() noexcept {
+        return {this, size_};
+    }
+
+    ConstIterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    ConstIterator end() const noexcept {
+        return {this, size_};
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Columns fresh = AllocateColumns(new_capacity);
+            RelocateInto(fresh, size_, 0);
+            Commit(std::move(fresh), new_capacity);
+        }
+    }
+
+    // Разрушает все записи, вместимость сохраняется
+    void Clear() noexcept {
+        ForEachIndex([&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            std::destroy_n(std::get<I>(columns_).Get(), size_);
+        });
+        size_ = 0;
+    }
+
+    // Изменяет размер; новые записи получают поля, инициализированные по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                std::destroy(std::get<I>(columns_).Get() + new_size, std::get<I>(columns_).Get() + size_);
+            });
+            size_ = new_size;
+            return;
+        }
+        if (new_size > capacity_) {
+            Reserve(GrownCapacity(new_size));
+        }
+        size_t done_columns = 0;
+        try {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                std::uninitialized_value_construct(std::get<I>(columns_).Get() + size_, std::get<I>(columns_).Get() + new_size);
+                ++done_columns;
+            });
+        } catch (...) {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                if (I < done_columns) {
+                    std::destroy(std::get<I>(columns_).Get() + size_, std::get<I>(columns_).Get() + new_size);
+                }
+            });
+            throw;
+        }
+        size_ = new_size;
+    }
+
+    // Добавляет запись с полями values. Если памяти не хватает, вместимость удваивается
+    void PushBack(const Fields&... values) {
+        EmplaceRow(size_, std::forward_as_tuple(values...));
+    }
+
+    void PushBack(Fields&&... values) {
+        EmplaceRow(size_, std::forward_as_tuple(std::move(values)...));
+    }
+
+    // Вставляет запись перед pos и возвращает итератор на неё
+    Iterator Insert(ConstIterator pos, const Fields&... values) {
+        assert(pos.GetIndex() <= size_);
+        return EmplaceRow(pos.GetIndex(), std::forward_as_tuple(values...));
+    }
+
+    Iterator Insert(ConstIterator pos, Fields&&... values) {
+        assert(pos.GetIndex() <= size_);
+        return EmplaceRow(pos.GetIndex(), std::forward_as_tuple(std::move(values)...));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        ForEachIndex([&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            std::destroy_at(std::get<I>(columns_).Get() + size_);
+        });
+    }
+
+    // Удаляет запись в позиции pos и возвращает итератор на следующую за ней
+    Iterator Erase(ConstIterator pos) {
+        const size_t index = pos.GetIndex();
+        assert(index < size_);
+        ForEachIndex([&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            auto* data = std::get<I>(columns_).Get();
+            std::move(data + index + 1, data + size_, data + index);
+        });
+        PopBack();
+        return {this, index};
+    }
+
+    void swap(SoASimpleVector& other) noexcept {
+        ForEachIndex([&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            std::get<I>(columns_).swap(std::get<I>(other.columns_));
+        });
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+private:
+    template <typename Func>
+    static void ForEachIndex(Func&& func) {
+        ForEachIndexImpl(func, Indices{});
+    }
+
+    template <typename Func, size_t... I>
+    static void ForEachIndexImpl(Func& func, std::index_sequence<I...>) {
+        (func(std::integral_constant<size_t, I>{}), ...);
+    }
+
+    template <size_t... I>
+    Row RowAt(size_t index, std::index_sequence<I...>) noexcept {
+        return Row(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    ConstRow RowAt(size_t index, std::index_sequence<I...>) const noexcept {
+        return ConstRow(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    std::tuple<Fields&&...> MovedRow(size_t index, std::index_sequence<I...>) noexcept {
+        return std::tuple<Fields&&...>(std::move(std::get<I>(columns_)[index])...);
+    }
+
+    // Столбцы, которые при перераспределении копируются, а не перемещаются
+    template <size_t I>
+    static constexpr bool kCopiesOnRelocate =
+        !IsTriviallyRelocatableV<FieldType<I>> && !std::is_nothrow_move_constructible_v<FieldType<I>>
+        && std::is_copy_constructible_v<FieldType<I>>;
+
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(DoublingGrowth::Next(capacity_, 0), required);
+    }
+
+    static Columns AllocateColumns(size_t capacity) {
+        return Columns(ArrayPtr<Fields>(capacity)...);
+    }
+
+    void Commit(Columns&& fresh, size_t new_capacity) noexcept {
+        columns_ = std::move(fresh);
+        capacity_ = new_capacity;
+    }
+
+    static void CopyColumns(const Columns& from, Columns& to, size_t count) {
+        size_t done_columns = 0;
+        try {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                std::uninitialized_copy_n(std::get<I>(from).Get(), count, std::get<I>(to).Get());
+                ++done_columns;
+            });
+        } catch (...) {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                if (I < done_columns) {
+                    std::destroy_n(std::get<I>(to).Get(), count);
+                }
+            });
+            throw;
+        }
+    }
+
+    // Переносит записи в fresh, оставляя gap_count свободных строк перед строкой gap.
+    // Сначала копируются столбцы без noexcept-перемещения: если копирование бросит исключение,
+    // исходные столбцы ещё не тронуты. Затем перемещаются остальные столбцы. Прервать этот шаг
+    // может только некопируемое поле с бросающим перемещением: тогда созданное в fresh
+    // разрушается, а в исходных столбцах остаются записи с перемещёнными полями.
+    // Исходные записи разрушаются, только когда перенесены все столбцы
+    void RelocateInto(Columns& fresh, size_t gap, size_t gap_count) {
+        bool built[kFieldCount] = {};
+        try {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                if constexpr (kCopiesOnRelocate<I>) {
+                    const auto* src = std::get<I>(columns_).Get();
+                    auto* dst = std::get<I>(fresh).Get();
+                    std::uninitialized_copy_n(src, gap, dst);
+                    try {
+                        std::uninitialized_copy(src + gap, src + size_, dst + gap + gap_count);
+                    } catch (...) {
+                        std::destroy_n(dst, gap);
+                        throw;
+                    }
+                    built[I] = true;
+                }
+            });
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                using Field = FieldType<I>;
+                auto* src = std::get<I>(columns_).Get();
+                auto* dst = std::get<I>(fresh).Get();
+                if constexpr (IsTriviallyRelocatableV<Field>) {
+                    if (size_ > 0) {
+                        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), gap * sizeof(Field));
+                        std::memcpy(static_cast<void*>(dst + gap + gap_count), static_cast<const void*>(src + gap),
+                                    (size_ - gap) * sizeof(Field));
+                    }
+                } else if constexpr (!kCopiesOnRelocate<I>) {
+                    std::uninitialized_move_n(src, gap, dst);
+                    try {
+                        std::uninitialized_move(src + gap, src + size_, dst + gap + gap_count);
+                    } catch (...) {
+                        std::destroy_n(dst, gap);
+                        throw;
+                    }
+                    built[I] = true;
+                }
+            });
+        } catch (...) {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                if (built[I]) {
+                    auto* dst = std::get<I>(fresh).Get();
+                    std::destroy_n(dst, gap);
+                    std::destroy(dst + gap + gap_count, dst + size_ + gap_count);
+                }
+            });
+            throw;
+        }
+        ForEachIndex([&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            if constexpr (!IsTriviallyRelocatableV<FieldType<I>>) {
+                std::destroy_n(std::get<I>(columns_).Get(), size_);
+            }
+        });
+    }
+
+    // Создаёт запись из кортежа аргументов args в строке row памяти columns.
+    // Если поле бросает исключение, уже созданные поля записи разрушаются
+    template <typename Tuple>
+    static void ConstructRow(Columns& columns, size_t row, Tuple&& args) {
+        size_t done_fields = 0;
+        try {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                ::new (static_cast<void*>(std::get<I>(columns).Get() + row))
+                    FieldType<I>(std::get<I>(std::forward<Tuple>(args)));
+                ++done_fields;
+            });
+        } catch (...) {
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                if (I < done_fields) {
+                    std::destroy_at(std::get<I>(columns).Get() + row);
+                }
+            });
+            throw;
+        }
+    }
+
+    template <typename Tuple>
+    Iterator EmplaceRow(size_t index, Tuple&& args) {
+        if (size_ == capacity_) {
+            // Запись создаётся в новой памяти до переноса: args могут ссылаться на поля самого вектора
+            const size_t new_capacity = GrownCapacity(size_ + 1);
+            Columns fresh = AllocateColumns(new_capacity);
+            ConstructRow(fresh, index, std::forward<Tuple>(args));
+            try {
+                RelocateInto(fresh, index, 1);
+            } catch (...) {
+                ForEachIndex([&](auto i) {
+                    constexpr size_t I = decltype(i)::value;
+                    std::destroy_at(std::get<I>(fresh).Get() + index);
+                });
+                throw;
+            }
+            Commit(std::move(fresh), new_capacity);
+        } else if (index == size_) {
+            ConstructRow(columns_, size_, std::forward<Tuple>(args));
+        } else {
+            // Временная запись нужна на случай, если args ссылаются на сдвигаемые поля
+            // Последняя запись сначала создаётся за концом во всех столбцах сразу,
+            // чтобы исключение не оставило столбцы разной длины
+            std::tuple<Fields...> row(std::forward<Tuple>(args));
+            ConstructRow(columns_, size_, MovedRow(size_ - 1, Indices{}));
+            ForEachIndex([&](auto i) {
+                constexpr size_t I = decltype(i)::value;
+                auto* data = std::get<I>(columns_).Get();
+                std::move_backward(data + index, data + size_ - 1, data + size_);
+                data[index] = std::move(std::get<I>(row));
+            });
+        }
+        ++size_;
+        return {this, index};
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
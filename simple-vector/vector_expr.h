@@ -0,0 +1,396 @@
+#pragma once
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "simple_vector.h"
+
+// Ленивые поэлементные выражения над SimpleVector арифметических типов.
+// Операторы +, -, *, / и функции Abs, Sqrt, Exp, Log, Min, Max не считают ничего сразу,
+// а строят дерево выражения. Присваивание выражения SimpleVector (или конструктор
+// из выражения) и свёртки Sum, Dot, Reduce вычисляют всё дерево за один проход
+// без промежуточных векторов, и этот цикл компилятор векторизует.
+// Размеры операндов проверяются при построении выражения, до вычисления:
+// при несовпадении выбрасывается std::invalid_argument. Число на месте операнда
+// распространяется на все элементы.
+// Выражение хранит указатели на данные векторов и действительно, пока они не изменены.
+// Вычисление в один из векторов-операндов корректно: элемент i зависит только от элементов i
+//     SimpleVector<double> d = a * 2.0 + b - c;
+//     a += Sqrt(b * b + c * c);
+//     double norm = Sum(a * a);
+
+namespace vector_expr {
+
+// Размер числа, стоящего на месте операнда
+inline constexpr size_t kBroadcast = static_cast<size_t>(-1);
+
+template <typename T>
+struct IsSimpleVector : std::false_type {
+};
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy>
+struct IsSimpleVector<SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>>
+    : std::bool_constant<std::is_arithmetic_v<Type> && !std::is_same_v<Type, bool>> {
+};
+
+template <typename T>
+inline constexpr bool kIsScalar = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// Операнд выражения: вектор арифметического типа или другое выражение
+template <typename T>
+inline constexpr bool kIsOperand = IsSimpleVector<T>::value || IsVectorExpressionV<T>;
+
+// Данные вектора
+template <typename T>
+class Leaf {
+public:
+    using IsVectorExpression = void;
+    using value_type = T;
+
+    Leaf(const T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    T operator[](size_t index) const noexcept {
+        return data_[index];
+    }
+
+private:
+    const T* data_;
+    size_t size_;
+};
+
+// Число, одинаковое для всех элементов
+template <typename T>
+class Scalar {
+public:
+    using IsVectorExpression = void;
+    using value_type = T;
+
+    explicit Scalar(T value) noexcept
+        : value_(value) {
+    }
+
+    size_t GetSize() const noexcept {
+        return kBroadcast;
+    }
+
+    T operator[](size_t) const noexcept {
+        return value_;
+    }
+
+private:
+    T value_;
+};
+
+template <typename Op, typename Arg>
+class Unary {
+public:
+    using IsVectorExpression = void;
+    using value_type = decltype(Op{}(std::declval<typename Arg::value_type>()));
+
+    explicit Unary(const Arg& arg) noexcept
+        : arg_(arg) {
+    }
+
+    size_t GetSize() const noexcept {
+        return arg_.GetSize();
+    }
+
+    value_type operator[](size_t index) const noexcept {
+        return Op{}(arg_[index]);
+    }
+
+private:
+    Arg arg_;
+};
+
+template <typename Op, typename Lhs, typename Rhs>
+class Binary {
+public:
+    using IsVectorExpression = void;
+    using value_type = decltype(Op{}(std::declval<typename Lhs::value_type>(), std::declval<typename Rhs::value_type>()));
+
+    // Выбрасывает std::invalid_argument, если размеры операндов различаются
+    Binary(const Lhs& lhs, const Rhs& rhs)
+        : lhs_(lhs)
+        , rhs_(rhs) {
+        const size_t lhs_size = lhs_.GetSize();
+        const size_t rhs_size = rhs_.GetSize();
+        if (lhs_size != kBroadcast && rhs_size != kBroadcast && lhs_size != rhs_size) {
+            throw std::invalid_argument("Vector sizes do not match");
+        }
+    }
+
+    size_t GetSize() const noexcept {
+        return lhs_.GetSize() != kBroadcast ? lhs_.GetSize() : rhs_.GetSize();
+    }
+
+    value_type operator[](size_t index) const noexcept {
+        return Op{}(lhs_[index], rhs_[index]);
+    }
+
+private:
+    Lhs lhs_;
+    Rhs rhs_;
+};
+
+template <typename T>
+auto AsOperand(const T& value) noexcept {
+    if constexpr (IsVectorExpressionV<T>) {
+        return value;
+    } else if constexpr (kIsScalar<T>) {
+        return Scalar<T>(value);
+    } else {
+        using Type = std::remove_const_t<std::remove_pointer_t<decltype(value.begin())>>;
+        return Leaf<Type>(value.begin(), value.GetSize());
+    }
+}
+
+template <typename T>
+using OperandOf = decltype(AsOperand(std::declval<const T&>()));
+
+// Хотя бы один из операндов - вектор или выражение, второй может быть числом
+template <typename Lhs, typename Rhs>
+using EnableIfBinary = std::enable_if_t<(kIsOperand<Lhs> && (kIsOperand<Rhs> || kIsScalar<Rhs>))
+                                        || (kIsScalar<Lhs> && kIsOperand<Rhs>)>;
+
+template <typename Arg>
+using EnableIfUnary = std::enable_if_t<kIsOperand<Arg>>;
+
+template <typename Op, typename Lhs, typename Rhs>
+Binary<Op, OperandOf<Lhs>, OperandOf<Rhs>> MakeBinary(const Lhs& lhs, const Rhs& rhs) {
+    return {AsOperand(lhs), AsOperand(rhs)};
+}
+
+template <typename Op, typename Arg>
+Unary<Op, OperandOf<Arg>> MakeUnary(const Arg& arg) noexcept {
+    return Unary<Op, OperandOf<Arg>>(AsOperand(arg));
+}
+
+struct AbsOp {
+    template <typename T>
+    auto operator()(T x) const noexcept {
+        if constexpr (std::is_unsigned_v<T>) {
+            return x;
+        } else {
+            return std::abs(x);
+        }
+    }
+};
+
+struct SqrtOp {
+    template <typename T>
+    auto operator()(T x) const noexcept {
+        return std::sqrt(x);
+    }
+};
+
+struct ExpOp {
+    template <typename T>
+    auto operator()(T x) const noexcept {
+        return std::exp(x);
+    }
+};
+
+struct LogOp {
+    template <typename T>
+    auto operator()(T x) const noexcept {
+        return std::log(x);
+    }
+};
+
+// Без ветвлений, чтобы цикл векторизовался в инструкции min и max
+struct MinOp {
+    template <typename L, typename R>
+    auto operator()(L lhs, R rhs) const noexcept {
+        using T = std::common_type_t<L, R>;
+        return static_cast<T>(rhs) < static_cast<T>(lhs) ? static_cast<T>(rhs) : static_cast<T>(lhs);
+    }
+};
+
+struct MaxOp {
+    template <typename L, typename R>
+    auto operator()(L lhs, R rhs) const noexcept {
+        using T = std::common_type_t<L, R>;
+        return static_cast<T>(lhs) < static_cast<T>(rhs) ? static_cast<T>(rhs) : static_cast<T>(lhs);
+    }
+};
+
+template <typename Lhs, typename Rhs, typename = EnableIfBinary<Lhs, Rhs>>
+auto operator+(const Lhs& lhs, const Rhs& rhs) {
+    return MakeBinary<std::plus<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = EnableIfBinary<Lhs, Rhs>>
+auto operator-(const Lhs& lhs, const Rhs& rhs) {
+    return MakeBinary<std::minus<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = EnableIfBinary<Lhs, Rhs>>
+auto operator*(const Lhs& lhs, const Rhs& rhs) {
+    return MakeBinary<std::multiplies<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = EnableIfBinary<Lhs, Rhs>>
+auto operator/(const Lhs& lhs, const Rhs& rhs) {
+    return MakeBinary<std::divides<>>(lhs, rhs);
+}
+
+template <typename Arg, typename = EnableIfUnary<Arg>>
+auto operator-(const Arg& arg) noexcept {
+    return MakeUnary<std::negate<>>(arg);
+}
+
+template <typename Arg, typename = EnableIfUnary<Arg>>
+auto Abs(const Arg& arg) noexcept {
+    return MakeUnary<AbsOp>(arg);
+}
+
+template <typename Arg, typename = EnableIfUnary<Arg>>
+auto Sqrt(const Arg& arg) noexcept {
+    return MakeUnary<SqrtOp>(arg);
+}
+
+template <typename Arg, typename = EnableIfUnary<Arg>>
+auto Exp(const Arg& arg) noexcept {
+    return MakeUnary<ExpOp>(arg);
+}
+
+template <typename Arg, typename = EnableIfUnary<Arg>>
+auto Log(const Arg& arg) noexcept {
+    return MakeUnary<LogOp>(arg);
+}
+
+// Поэлементные минимум и максимум
+template <typename Lhs, typename Rhs, typename = EnableIfBinary<Lhs, Rhs>>
+auto Min(const Lhs& lhs, const Rhs& rhs) {
+    return MakeBinary<MinOp>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = EnableIfBinary<Lhs, Rhs>>
+auto Max(const Lhs& lhs, const Rhs& rhs) {
+    return MakeBinary<MaxOp>(lhs, rhs);
+}
+
+// Свёртка init op e[0] op e[1] ... за один проход
+template <typename Arg, typename T, typename Op, typename = EnableIfUnary<Arg>>
+T Reduce(const Arg& arg, T init, Op op) {
+    const auto operand = AsOperand(arg);
+    const size_t size = operand.GetSize();
+    for (size_t i = 0; i < size; ++i) {
+        init = op(init, operand[i]);
+    }
+    return init;
+}
+
+// Сумма элементов. Выражение вычисляется кусками в буфер на стеке, а буфер
+// складывается в kLanes независимых накопителей, чтобы сложения шли векторами:
+// в одном цикле компилятор не векторизует такую свёртку. Для чисел с плавающей
+// точкой порядок сложения поэтому отличается от последовательного
+template <typename Arg, typename = EnableIfUnary<Arg>>
+auto Sum(const Arg& arg) {
+    constexpr size_t kChunk = 256;
+    constexpr size_t kLanes = 8;
+    const auto operand = AsOperand(arg);
+    using T = typename decltype(operand)::value_type;
+    const size_t size = operand.GetSize();
+    T partial[kLanes] = {};
+    T chunk[kChunk];
+    for (size_t first = 0; first < size; first += kChunk) {
+        const size_t count = std::min(kChunk, size - first);
+        for (size_t i = 0; i < count; ++i) {
+            chunk[i] = operand[first + i];
+        }
+        size_t i = 0;
+        for (; i + kLanes <= count; i += kLanes) {
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                partial[lane] += chunk[i + lane];
+            }
+        }
+        for (; i < count; ++i) {
+            partial[0] += chunk[i];
+        }
+    }
+    T sum = T();
+    for (T value : partial) {
+        sum += value;
+    }
+    return sum;
+}
+
+// Скалярное произведение
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsOperand<Lhs> && kIsOperand<Rhs>>>
+auto Dot(const Lhs& lhs, const Rhs& rhs) {
+    return Sum(lhs * rhs);
+}
+
+// Записывает значения выражения в out[0, size): в неинициализированную память
+// или поверх элементов арифметического типа
+template <typename Expr, typename Type>
+void EvaluateInto(const Expr& expr, Type* out) noexcept {
+    const size_t size = expr.GetSize();
+    for (size_t i = 0; i < size; ++i) {
+        new (out + i) Type(static_cast<Type>(expr[i]));
+    }
+}
+
+// Составное присваивание вычисляется на месте: a += e равносильно a = a + e
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy, typename Rhs,
+          typename = EnableIfBinary<SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>, Rhs>>
+SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& operator+=(SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs,
+                                                                 const Rhs& rhs) {
+    return lhs = lhs + rhs;
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy, typename Rhs,
+          typename = EnableIfBinary<SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>, Rhs>>
+SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& operator-=(SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs,
+                                                                 const Rhs& rhs) {
+    return lhs = lhs - rhs;
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy, typename Rhs,
+          typename = EnableIfBinary<SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>, Rhs>>
+SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& operator*=(SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs,
+                                                                 const Rhs& rhs) {
+    return lhs = lhs * rhs;
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename StatsPolicy, typename Rhs,
+          typename = EnableIfBinary<SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>, Rhs>>
+SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& operator/=(SimpleVector<Type, Alloc, GrowthPolicy, StatsPolicy>& lhs,
+                                                                 const Rhs& rhs) {
+    return lhs = lhs / rhs;
+}
+
+}  // namespace vector_expr
+
+// SimpleVector живёт в глобальном пространстве имён, поэтому операторы для него
+// должны находиться и оттуда; для самих выражений их находит поиск по аргументам
+using vector_expr::operator+;
+using vector_expr::operator-;
+using vector_expr::operator*;
+using vector_expr::operator/;
+using vector_expr::operator+=;
+using vector_expr::operator-=;
+using vector_expr::operator*=;
+using vector_expr::operator/=;
+using vector_expr::Abs;
+using vector_expr::Dot;
+using vector_expr::Exp;
+using vector_expr::Log;
+using vector_expr::Max;
+using vector_expr::Min;
+using vector_expr::Reduce;
+using vector_expr::Sqrt;
+using vector_expr::Sum;
@@ -0,0 +1,163 @@
+#pragma once
+#include <cstdlib>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// Политики сбора статистики SimpleVector.
+// Политика - это тип со статическими методами, которые вектор вызывает
+// в моменты работы с памятью:
+//     OnAllocate(capacity, bytes)      - выделен буфер под capacity элементов;
+//     OnRelocate(moved, copied, bytes) - элементы перенесены в новый буфер;
+//     OnRelease(capacity, size)        - буфер освобождён, в нём было size элементов.
+// NoStats ничего не делает, и вызовы полностью исчезают при компиляции
+
+struct NoStats {
+    static void OnAllocate(size_t, size_t) noexcept {
+    }
+    static void OnRelocate(size_t, size_t, size_t) noexcept {
+    }
+    static void OnRelease(size_t, size_t) noexcept {
+    }
+};
+
+// Счётчики одной метки. Обновляются из любых потоков без блокировок
+struct VectorStats {
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes_allocated{0};
+    std::atomic<size_t> elements_moved{0};
+    std::atomic<size_t> elements_copied{0};
+    std::atomic<size_t> bytes_relocated{0};
+    std::atomic<size_t> peak_capacity{0};
+    // Сумма незанятых ячеек в буферах на момент их освобождения
+    std::atomic<size_t> wasted_capacity{0};
+    std::atomic<size_t> buffers_released{0};
+
+    void Reset() noexcept {
+        for (auto* counter : {&allocations, &bytes_allocated, &elements_moved, &elements_copied,
+                              &bytes_relocated, &peak_capacity, &wasted_capacity, &buffers_released}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Глобальный потокобезопасный реестр счётчиков по меткам
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    // Возвращает счётчики метки name, создавая их при первом обращении.
+    // Для уже созданной метки ничего не выделяет.
+    // Ссылка остаётся действительной до конца программы
+    VectorStats& Get(std::string_view name) {
+        std::lock_guard guard(mutex_);
+        auto it = stats_.find(name);
+        if (it == stats_.end()) {
+            it = stats_.emplace(std::string(name), std::make_unique<VectorStats>()).first;
+        }
+        return *it->second;
+    }
+
+    void Reset() {
+        std::lock_guard guard(mutex_);
+        for (auto& [name, stats] : stats_) {
+            stats->Reset();
+        }
+    }
+
+    // Выводит все метки в виде JSON-объекта {"метка": {"счётчик": значение, ...}, ...}
+    std::string ToJson() const {
+        std::lock_guard guard(mutex_);
+        std::ostringstream out;
+        out << '{';
+        bool first = true;
+        for (const auto& [name, stats] : stats_) {
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+            out << '"' << EscapeJson(name) << "\":{"
+                << "\"allocations\":" << stats->allocations.load()
+                << ",\"bytes_allocated\":" << stats->bytes_allocated.load()
+                << ",\"elements_moved\":" << stats->elements_moved.load()
+                << ",\"elements_copied\":" << stats->elements_copied.load()
+                << ",\"bytes_relocated\":" << stats->bytes_relocated.load()
+                << ",\"peak_capacity\":" << stats->peak_capacity.load()
+                << ",\"wasted_capacity\":" << stats->wasted_capacity.load()
+                << ",\"buffers_released\":" << stats->buffers_released.load()
+                << '}';
+        }
+        out << '}';
+        return out.str();
+    }
+
+private:
+    VectorStatsRegistry() = default;
+
+    static std::string EscapeJson(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<VectorStats>, std::less<>> stats_;
+};
+
+// Собирает статистику под меткой Tag::kName в VectorStatsRegistry.
+// Tag - любой тип со статическим полем kName, например объявленный
+// макросом SIMPLE_VECTOR_STATS_TAG. Такая метка регистрируется при запуске программы,
+// поэтому методы-события не выделяют память. Метку, объявленную вручную, регистрирует
+// первое событие, и нехватка памяти в этот момент завершает программу
+template <typename Tag>
+struct TaggedStats {
+    static VectorStats& Counters() {
+        static VectorStats& stats = VectorStatsRegistry::Instance().Get(Tag::kName);
+        return stats;
+    }
+
+    static void OnAllocate(size_t capacity, size_t bytes) noexcept {
+        VectorStats& stats = Counters();
+        stats.allocations.fetch_add(1, std::memory_order_relaxed);
+        stats.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        size_t peak = stats.peak_capacity.load(std::memory_order_relaxed);
+        while (peak < capacity && !stats.peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnRelocate(size_t moved, size_t copied, size_t bytes) noexcept {
+        VectorStats& stats = Counters();
+        stats.elements_moved.fetch_add(moved, std::memory_order_relaxed);
+        stats.elements_copied.fetch_add(copied, std::memory_order_relaxed);
+        stats.bytes_relocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    static void OnRelease(size_t capacity, size_t size) noexcept {
+        VectorStats& stats = Counters();
+        stats.wasted_capacity.fetch_add(capacity - size, std::memory_order_relaxed);
+        stats.buffers_released.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Объявляет метку статистики с именем, включающим место объявления в коде:
+//     SIMPLE_VECTOR_STATS_TAG(RequestIds);
+//     SimpleVector<int, std::allocator<int>, DoublingGrowth, TaggedStats<RequestIds>> ids;
+#define SIMPLE_VECTOR_STATS_TAG(TagName)                                               \
+    struct TagName {                                                                    \
+        static constexpr const char* kName = #TagName " @ " __FILE__ ":" SIMPLE_VECTOR_STATS_STR(__LINE__); \
+        static inline const bool kRegistered = (VectorStatsRegistry::Instance().Get(kName), true); \
+    }
+#define SIMPLE_VECTOR_STATS_STR(x) SIMPLE_VECTOR_STATS_STR_IMPL(x)
+#define SIMPLE_VECTOR_STATS_STR_IMPL(x) #x